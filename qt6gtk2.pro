@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 
 SUBDIRS += src/qt6gtk2-qtplugin src/qt6gtk2-style
+qtHaveModule(testlib): SUBDIRS += tests
 
 include(qt6gtk2.pri)
 
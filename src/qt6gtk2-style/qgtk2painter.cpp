@@ -27,239 +27,920 @@
 // and takes care of converting all such calls into cached Qt pixmaps.
 
 #include "qgtkstyle_p_p.h"
-#include <private/qhexstring_p.h>
+#include "qgtkpixmapcache_p.h"
+#include "qgtkrendertheme_p.h"
+#include "qgtkshmreadback_p.h"
+#include "qgtkstats_p.h"
 #include <QWidget>
-#include <QPixmapCache>
+#include <QElapsedTimer>
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE
 
-// To recover alpha we apply the gtk painting function two times to
-// white, and black window backgrounds. This can be used to
-// recover the premultiplied alpha channel
-QPixmap QGtk2Painter::renderTheme(uchar *bdata, uchar *wdata, const QRect &rect) const
-{
-    const int bytecount = rect.width() * rect.height() * 4;
-    for (int index = 0; index < bytecount ; index += 4) {
-        uchar val = bdata[index + GTK_BLUE];
-        if (m_alpha) {
-            int alphaval = qMax(bdata[index + GTK_BLUE] - wdata[index + GTK_BLUE],
-                                bdata[index + GTK_GREEN] - wdata[index + GTK_GREEN]);
-            alphaval = qMax(alphaval, bdata[index + GTK_RED] - wdata[index + GTK_RED]) + 255;
-            bdata[index + QT_ALPHA] = alphaval;
+// Mirrors the 32 bit pixels of data in place. QImage::mirrored() would copy
+// a buffer the image does not own first.
+static void qt_gtk_mirror(uchar *data, const QSize &size, bool horizontal, bool vertical)
+{
+    quint32 *pixels = reinterpret_cast<quint32 *>(data);
+    const int width = size.width();
+    const int height = size.height();
+    if (vertical) {
+        for (int y = 0; y < height / 2; ++y)
+            std::swap_ranges(pixels + y * width, pixels + (y + 1) * width, pixels + (height - 1 - y) * width);
+    }
+    if (horizontal) {
+        for (int y = 0; y < height; ++y)
+            std::reverse(pixels + y * width, pixels + (y + 1) * width);
+    }
+}
+
+// Takes ownership of bdata, which must be allocated with malloc() and
+// hold width * 4 byte rows. The image adopts the buffer, so the pixmap
+// ends up sharing it instead of a copy.
+QPixmap QGtk2Painter::renderTheme(uchar *bdata, const uchar *wdata, const QSize &size) const
+{
+    static const QGtkRenderThemeFunction renderThemeFunction = qt_gtk_resolve_render_theme();
+    renderThemeFunction(bdata, m_alpha ? wdata : nullptr, size.width() * size.height());
+
+    // drop the stacked white render, if any; shrinking keeps the data
+    const qsizetype bytesPerLine = qsizetype(size.width()) * 4;
+    if (uchar *shrunk = (uchar*)realloc(bdata, bytesPerLine * size.height()))
+        bdata = shrunk;
+
+    if (m_hflipped || m_vflipped)
+        qt_gtk_mirror(bdata, size, m_hflipped, m_vflipped);
+
+    QImage converted(bdata, size.width(), size.height(), bytesPerLine, m_alpha ?
+                     QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32, free, bdata);
+    return QPixmap::fromImage(std::move(converted));
+}
+
+// Theme background pixmaps are tiled from the origin of the drawable, so
+// stacking two renders into one drawable would give them different phases.
+static bool qt_gtk_style_has_bg_pixmap(GtkStyle *style)
+{
+    for (int state = GTK_STATE_NORMAL; state <= GTK_STATE_INSENSITIVE; ++state) {
+        if (style->bg_pixmap[state])
+            return true;
+    }
+    return false;
+}
+
+// Renders on a miss reuse drawables of a few size classes rather than
+// creating and destroying a server side pixmap each time. They are
+// released once the painter has been idle for a while.
+static const int ScratchMinSize = 32;
+static const int ScratchMaxSize = 1024;
+static const int ScratchMaxPixmaps = 8;
+static const int ScratchIdleTimeout = 5000;
+// GTK_STATE_NORMAL up to GTK_STATE_INSENSITIVE
+static const int StateCount = 5;
+
+static int qt_gtk_scratch_class(int size)
+{
+    int sizeClass = ScratchMinSize;
+    while (sizeClass < size)
+        sizeClass *= 2;
+    return sizeClass;
+}
+
+// Returns a drawable of at least size for the depth of window, the caller
+// unrefs it as usual.
+GdkPixmap *QGtk2Painter::scratchPixmap(GdkWindow *window, const QSize &size) const
+{
+    // Restarting the timer on every miss costs more than the miss saves,
+    // the timeout checks for use since it was started instead
+    m_scratchUsed = true;
+    if (!m_scratchTimer.isActive())
+        m_scratchTimer.start(ScratchIdleTimeout);
+    if (size.width() > ScratchMaxSize || size.height() > ScratchMaxSize)
+        return gdk_pixmap_new((GdkDrawable*)window, size.width(), size.height(), -1);
+
+    const QSize sizeClass(qt_gtk_scratch_class(size.width()), qt_gtk_scratch_class(size.height()));
+    for (int i = 0; i < m_scratchPixmaps.size(); ++i) {
+        const ScratchPixmap &scratch = m_scratchPixmaps.at(i);
+        if (scratch.window == window && scratch.size == sizeClass) {
+            // most recently used last
+            m_scratchPixmaps.move(i, m_scratchPixmaps.size() - 1);
+            return (GdkPixmap*)g_object_ref(scratch.pixmap);
         }
-        bdata[index + QT_RED] = bdata[index + GTK_RED];
-        bdata[index + QT_GREEN] = bdata[index + GTK_GREEN];
-        bdata[index + QT_BLUE] = val;
     }
-    QImage converted((const uchar*)bdata, rect.width(), rect.height(), m_alpha ?
-                     QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
 
-    if (m_hflipped || m_vflipped) {
-        return QPixmap::fromImage(converted.mirrored(m_hflipped, m_vflipped));
+    GdkPixmap *pixmap = gdk_pixmap_new((GdkDrawable*)window, sizeClass.width(), sizeClass.height(), -1);
+    if (!pixmap)
+        return nullptr;
+    if (m_scratchPixmaps.size() == ScratchMaxPixmaps)
+        gdk_drawable_unref(m_scratchPixmaps.takeFirst().pixmap);
+    m_scratchPixmaps.append({ window, sizeClass, pixmap });
+    return (GdkPixmap*)g_object_ref(pixmap);
+}
+
+void QGtk2Painter::scratchTimeout() const
+{
+    if (m_scratchUsed) {
+        m_scratchUsed = false;
+        m_scratchTimer.start(ScratchIdleTimeout);
+        return;
     }
-    // on raster graphicssystem we need to do a copy here, because
-    // we intend to deallocate the qimage bits shortly after...
-    return QPixmap::fromImage(converted.copy());
+    releaseScratch();
+}
+
+void QGtk2Painter::releaseScratch() const
+{
+    m_scratchTimer.stop();
+    m_scratchUsed = false;
+    for (const ScratchPixmap &scratch : std::as_const(m_scratchPixmaps))
+        gdk_drawable_unref(scratch.pixmap);
+    m_scratchPixmaps.clear();
+    m_whiteBuffer = QByteArray();
+    QGtkShmReadback::release();
+}
+
+static bool qt_gtk_is_opaque(const QImage &image)
+{
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            if (qAlpha(line[x]) != 255)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Whether two renders agree, up to rounding in the alpha recovery
+static bool qt_gtk_same_pixels(const QImage &image, const QImage &reference)
+{
+    if (image.isNull() || image.size() != reference.size())
+        return false;
+    const QImage a = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const QImage b = reference.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const int tolerance = 2;
+    for (int y = 0; y < a.height(); ++y) {
+        const QRgb *aLine = reinterpret_cast<const QRgb *>(a.constScanLine(y));
+        const QRgb *bLine = reinterpret_cast<const QRgb *>(b.constScanLine(y));
+        for (int x = 0; x < a.width(); ++x) {
+            if (qAbs(qAlpha(aLine[x]) - qAlpha(bLine[x])) > tolerance
+                    || qAbs(qRed(aLine[x]) - qRed(bLine[x])) > tolerance
+                    || qAbs(qGreen(aLine[x]) - qGreen(bLine[x])) > tolerance
+                    || qAbs(qBlue(aLine[x]) - qBlue(bLine[x])) > tolerance)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Renders a GtkStyle painting function onto a QPixmap of size device pixels.
+// GTK+ 2 can only paint into server side drawables, so the element is
+// drawn into a GdkPixmap and its pixels are read back.
+//
+// Whether the element identified by key came out fully opaque is
+// remembered for every size, later renders of it then skip recovering
+// the alpha channel. Everything else in the key, such as the detail
+// of options and checkboxes, tells elements apart.
+//
+// An engine may draw some primitives with cairo and others with GCs,
+// which leave the alpha bits of ARGB pixels unset. So the first ARGB
+// render of every element is checked against the two pass one, and
+// elements that differ keep using the two pass render.
+QPixmap QGtk2Painter::renderToPixmap(GtkStyle *style, const QGtkPainterKey &key, const QSize &size,
+                                     const DrawFunction &draw)
+{
+    QGtkPainterKey opacityKey = key;
+    opacityKey.width = 0;
+    opacityKey.height = 0;
+    opacityKey.dpr = 0;
+    opacityKey.flags &= ~0x7; // alpha and flips
+
+    applyWidgetState();
+    QPixmap cache;
+    auto it = m_opaqueElements.constFind(opacityKey);
+    if (!m_alpha || (it != m_opaqueElements.constEnd() && *it)) {
+        const bool alpha = m_alpha;
+        m_alpha = false;
+        cache = renderToDefaultPixmap(style, size, draw);
+        m_alpha = alpha;
+    } else {
+        const bool argb = argbWindow() && !m_argbRejected.contains(opacityKey);
+        cache = argb ? renderToArgbPixmap(style, size, draw) : renderToDefaultPixmap(style, size, draw);
+        if (it == m_opaqueElements.constEnd() && !cache.isNull()) {
+            QImage image = cache.toImage();
+            cache = QPixmap();
+            if (argb) {
+                QImage reference = renderToDefaultPixmap(style, size, draw).toImage();
+                if (!qt_gtk_same_pixels(image, reference)) {
+                    m_argbRejected.insert(opacityKey);
+                    image = std::move(reference);
+                }
+            }
+            const bool opaque = qt_gtk_is_opaque(image);
+            m_opaqueElements.insert(opacityKey, opaque);
+            // keep the image unshared, so this does not copy it
+            if (opaque)
+                image.reinterpretAsFormat(QImage::Format_RGB32);
+            cache = QPixmap::fromImage(std::move(image));
+        }
+    }
+    restoreWidgetState();
+    cache.setDevicePixelRatio(m_dpr);
+    if (QGtkStats::isEnabled() && !cache.isNull())
+        QGtkStats::miss(qint64(cache.width()) * cache.height() * 4);
+    return cache;
+}
+
+// Brings the proto widgets into the state the style asked for. Focus and
+// the default button are taken back after the render, as the style did
+// before; directions and adjustments are left to the widgets.
+void QGtk2Painter::applyWidgetState()
+{
+    for (WidgetDirection &d : m_widgetDirections) {
+        if (!d.dirty)
+            continue;
+        gtk_widget_set_direction(d.widget, d.direction);
+        d.dirty = false;
+    }
+    for (RangeAdjustment &a : m_rangeAdjustments) {
+        if (a.invertedDirty) {
+            gtk_range_set_inverted(a.range, a.inverted);
+            a.invertedDirty = false;
+        }
+        if (!a.dirty)
+            continue;
+        if (GtkAdjustment *adjustment = gtk_range_get_adjustment(a.range))
+            gtk_adjustment_configure(adjustment, a.values[0], a.values[1], a.values[2],
+                                     a.values[3], a.values[4], a.values[5]);
+        a.dirty = false;
+    }
+    if (m_defaultWidget) {
+        gtk_widget_set_can_default(m_defaultWidget, true);
+        gtk_window_set_default((GtkWindow*)gtk_widget_get_toplevel(m_defaultWidget), m_defaultWidget);
+    }
+    for (GtkWidget *widget : m_focusWidgets)
+        QGtkStylePrivate::gtkWidgetSetFocus(widget, true);
+}
+
+void QGtk2Painter::restoreWidgetState()
+{
+    for (GtkWidget *widget : m_focusWidgets)
+        QGtkStylePrivate::gtkWidgetSetFocus(widget, false);
+    if (m_defaultWidget)
+        gtk_window_set_default((GtkWindow*)gtk_widget_get_toplevel(m_defaultWidget), nullptr);
+}
+
+// Returns the height of the drawable renderToDefaultPixmap() uses for a
+// render of height, which is doubled when the white render is stacked.
+int QGtk2Painter::drawableHeight(GtkStyle *style, int height) const
+{
+    const bool stacked = m_alpha && m_singleReadback && !qt_gtk_style_has_bg_pixmap(style);
+    return stacked ? 2 * height : height;
+}
+
+// Draws into a pixmap of the default depth. Alpha is recovered from a
+// black and a white render, which are stacked into one pixmap of double
+// height to read both back in one go.
+QPixmap QGtk2Painter::renderToDefaultPixmap(GtkStyle *style, const QSize &size, const DrawFunction &draw) const
+{
+    const int width = size.width();
+    const int height = size.height();
+    style = gtk_style_attach(style, m_window->window);
+    const int pixmapHeight = drawableHeight(style, height);
+    const bool stacked = pixmapHeight != height;
+
+    GdkPixmap *pixmap = scratchPixmap(m_window->window, QSize(width, pixmapHeight));
+    if (!pixmap)
+        return QPixmap();
+
+    // invalid unless statistics are collected
+    QElapsedTimer timer;
+    if (QGtkStats::isEnabled())
+        timer.start();
+    GdkRectangle area = {0, 0, width, height};
+    gdk_draw_rectangle(pixmap, m_alpha ? style->black_gc : *style->bg_gc, true, 0, 0, width, height);
+    draw(pixmap, style, &area, 0, 0);
+    if (stacked) {
+        GdkRectangle whiteArea = {0, height, width, height};
+        gdk_draw_rectangle(pixmap, style->white_gc, true, 0, height, width, height);
+        draw(pixmap, style, &whiteArea, 0, height);
+    }
+    QGtkStats::addTime(QGtkStats::RenderTime, timer);
+
+    // read back into our own buffer, which renderTheme() hands over to the
+    // image; only the rendered part of the drawable is read
+    const int rowstride = width * 4;
+    uchar *bdata = (uchar*)malloc(qsizetype(rowstride) * pixmapHeight);
+    if (!bdata) {
+        gdk_drawable_unref(pixmap);
+        return QPixmap();
+    }
+    if (!QGtkShmReadback::read(m_window->window, pixmap, width, pixmapHeight, bdata)) {
+        GdkPixbuf *imgb = gdk_pixbuf_new_from_data(bdata, GDK_COLORSPACE_RGB, true, 8, width, pixmapHeight,
+                                                   rowstride, nullptr, nullptr);
+        gdk_pixbuf_get_from_drawable(imgb, pixmap, nullptr, 0, 0, 0, 0, width, pixmapHeight);
+        g_object_unref(imgb);
+    }
+    QGtkStats::addTime(QGtkStats::ReadbackTime, timer);
+
+    QPixmap cache;
+    if (stacked) {
+        cache = renderTheme(bdata, bdata + rowstride * height, size);
+    } else if (m_alpha) {
+        gdk_draw_rectangle(pixmap, style->white_gc, true, 0, 0, width, height);
+        draw(pixmap, style, &area, 0, 0);
+        QGtkStats::addTime(QGtkStats::RenderTime, timer);
+        // the white render is only needed until renderTheme() returns
+        if (m_whiteBuffer.size() < qsizetype(rowstride) * height)
+            m_whiteBuffer.resize(qsizetype(rowstride) * height);
+        uchar *wdata = reinterpret_cast<uchar*>(m_whiteBuffer.data());
+        if (!QGtkShmReadback::read(m_window->window, pixmap, width, height, wdata)) {
+            GdkPixbuf *imgw = gdk_pixbuf_new_from_data(wdata, GDK_COLORSPACE_RGB, true, 8, width, height,
+                                                       rowstride, nullptr, nullptr);
+            gdk_pixbuf_get_from_drawable(imgw, pixmap, nullptr, 0, 0, 0, 0, width, height);
+            g_object_unref(imgw);
+        }
+        QGtkStats::addTime(QGtkStats::ReadbackTime, timer);
+        cache = renderTheme(bdata, wdata, size);
+    } else {
+        cache = renderTheme(bdata, nullptr, size);
+    }
+    QGtkStats::addTime(QGtkStats::ConvertTime, timer);
+    gdk_drawable_unref(pixmap);
+    return cache;
+}
+
+// Draws into a 32 bit pixmap of the ARGB visual, which keeps the real
+// alpha channel, so a single render and readback is enough.
+QPixmap QGtk2Painter::renderToArgbPixmap(GtkStyle *style, const QSize &size, const DrawFunction &draw) const
+{
+    const int width = size.width();
+    const int height = size.height();
+    GdkPixmap *pixmap = scratchPixmap(m_argbWindow->window, size);
+    if (!pixmap)
+        return QPixmap();
+
+    QElapsedTimer timer;
+    if (QGtkStats::isEnabled())
+        timer.start();
+    style = gtk_style_attach(style, m_argbWindow->window);
+    cairo_t *cr = gdk_cairo_create(pixmap);
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_fill(cr);
+    cairo_destroy(cr);
+    GdkRectangle area = {0, 0, width, height};
+    draw(pixmap, style, &area, 0, 0);
+    QGtkStats::addTime(QGtkStats::RenderTime, timer);
+
+    // Cairo's ARGB32 is premultiplied in native byte order, just like QImage's
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    cairo_surface_t *surface = cairo_image_surface_create_for_data(image.bits(), CAIRO_FORMAT_ARGB32,
+                                                                   width, height, image.bytesPerLine());
+    cr = cairo_create(surface);
+    gdk_cairo_set_source_pixmap(cr, pixmap, 0, 0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    gdk_drawable_unref(pixmap);
+    QGtkStats::addTime(QGtkStats::ReadbackTime, timer);
+
+    if (m_hflipped || m_vflipped)
+        return QPixmap::fromImage(std::move(image).mirrored(m_hflipped, m_vflipped));
+    return QPixmap::fromImage(std::move(image));
+}
+
+// Returns the window used for ARGB rendering, or nullptr when the X server
+// has no ARGB visual or the theme does not render correctly into it.
+GtkWidget *QGtk2Painter::argbWindow()
+{
+    if (m_argbChecked)
+        return m_argbWindow;
+    m_argbChecked = true;
+
+    if (qgetenv("QT6GTK2_ARGB_RENDERING") == "0")
+        return nullptr;
+    GdkColormap *colormap = gdk_screen_get_rgba_colormap(gtk_widget_get_screen(m_window));
+    if (!colormap)
+        return nullptr;
+
+    m_argbWindow = gtk_window_new(GTK_WINDOW_POPUP);
+    gtk_widget_set_colormap(m_argbWindow, colormap);
+    gtk_widget_realize(m_argbWindow);
+    if (!verifyArgbRendering()) {
+        gtk_widget_destroy(m_argbWindow);
+        m_argbWindow = nullptr;
+    }
+    return m_argbWindow;
+}
+
+// Some engines and GC based drawing do not set the alpha bits of ARGB
+// pixels. Render a button through both paths and compare the pixels; an
+// engine that fails here is not tried per element.
+bool QGtk2Painter::verifyArgbRendering()
+{
+    GtkWidget *gtkButton = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Button);
+    if (!gtkButton)
+        return false;
+
+    const QSize size(24, 24);
+    const DrawFunction draw = [&](GdkPixmap *pixmap, GtkStyle *style, GdkRectangle *area, gint left, gint top) {
+        gtk_paint_box(style, pixmap, GTK_STATE_NORMAL, GTK_SHADOW_OUT, area, gtkButton, "button",
+                      left, top, size.width(), size.height());
+    };
+
+    const bool alpha = m_alpha;
+    const bool hflipped = m_hflipped;
+    const bool vflipped = m_vflipped;
+    m_alpha = true;
+    m_hflipped = m_vflipped = false;
+    GtkStyle *style = gtk_widget_get_style(gtkButton);
+    const QImage argb = renderToArgbPixmap(style, size, draw).toImage();
+    const QImage reference = renderToDefaultPixmap(style, size, draw).toImage();
+    m_alpha = alpha;
+    m_hflipped = hflipped;
+    m_vflipped = vflipped;
+
+    return qt_gtk_same_pixels(argb, reference);
+}
+
+// Elements larger than NineSliceThreshold along a stretchable axis are
+// rendered and cached at NineSliceExtent along that axis only, the size
+// asked for is then composed by stretching their uniform middle rows or
+// columns. The borders are probed once per canonical render.
+static const int NineSliceThreshold = 128;
+static const int NineSliceExtent = 64;
+// Thickness of the strips the stretched parts are tiled from
+static const int NineSliceTile = 16;
+// The strips make slices worth keeping, but not without bound
+static const int NineSliceMaxEntries = 512;
+
+static bool qt_gtk_rows_equal(const QImage &image, int y1, int y2)
+{
+    return !memcmp(image.constScanLine(y1), image.constScanLine(y2), image.width() * sizeof(QRgb));
+}
+
+static bool qt_gtk_columns_equal(const QImage &image, int x1, int x2)
+{
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        if (line[x1] != line[x2])
+            return false;
+    }
+    return true;
+}
+
+// A middle row or column of the canonical render, repeated to NineSliceTile
+// pixels so that tiling it takes few blits
+static QPixmap qt_gtk_row_tile(const QImage &image, int x, int width, int y, qreal dpr)
+{
+    if (width <= 0)
+        return QPixmap();
+    QImage tile(width, NineSliceTile, image.format());
+    for (int row = 0; row < tile.height(); ++row)
+        memcpy(tile.scanLine(row), image.constScanLine(y) + x * 4, width * 4);
+    tile.setDevicePixelRatio(dpr);
+    return QPixmap::fromImage(std::move(tile));
+}
+
+static QPixmap qt_gtk_column_tile(const QImage &image, int y, int height, int x, qreal dpr)
+{
+    if (height <= 0)
+        return QPixmap();
+    QImage tile(NineSliceTile, height, image.format());
+    for (int row = 0; row < height; ++row) {
+        const QRgb pixel = reinterpret_cast<const QRgb *>(image.constScanLine(y + row))[x];
+        std::fill_n(reinterpret_cast<QRgb *>(tile.scanLine(row)), tile.width(), pixel);
+    }
+    tile.setDevicePixelRatio(dpr);
+    return QPixmap::fromImage(std::move(tile));
+}
+
+// Borders are in pixels of pixmap, rect is in logical coordinates. The
+// corners are blitted from pixmap, the stretched parts are tiled from the
+// strips of the slice.
+void QGtk2Painter::drawNineSlice(QPainter *painter, const QRect &rect, const QPixmap &pixmap,
+                                 const NineSlice &slice)
+{
+    const QMargins &borders = slice.borders;
+    const qreal dpr = pixmap.devicePixelRatio();
+    const int sx[4] = { 0, borders.left(), pixmap.width() - borders.right(), pixmap.width() };
+    const int sy[4] = { 0, borders.top(), pixmap.height() - borders.bottom(), pixmap.height() };
+    const qreal tx[4] = { qreal(rect.x()), rect.x() + borders.left() / dpr,
+                          rect.x() + rect.width() - borders.right() / dpr, qreal(rect.x() + rect.width()) };
+    const qreal ty[4] = { qreal(rect.y()), rect.y() + borders.top() / dpr,
+                          rect.y() + rect.height() - borders.bottom() / dpr, qreal(rect.y() + rect.height()) };
+
+    // the stretched rows and columns are uniform, filtering would only
+    // bleed the borders into them
+    const bool smooth = painter->testRenderHint(QPainter::SmoothPixmapTransform);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            if (sx[column] == sx[column + 1] || sy[row] == sy[row + 1])
+                continue;
+            const QRectF target(tx[column], ty[row], tx[column + 1] - tx[column], ty[row + 1] - ty[row]);
+            if (row == 1 && !slice.rowTiles[column].isNull())
+                painter->drawTiledPixmap(target, slice.rowTiles[column]);
+            else if (column == 1 && !slice.columnTiles[row].isNull())
+                painter->drawTiledPixmap(target, slice.columnTiles[row]);
+            else
+                painter->drawPixmap(target, pixmap,
+                                    QRectF(sx[column], sy[row], sx[column + 1] - sx[column], sy[row + 1] - sy[row]));
+        }
+    }
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, smooth);
+}
+
+// Finds the uniform rows and columns around the middle of the canonical
+// render and checks that stretching them reproduces a larger render.
+QGtk2Painter::NineSlice QGtk2Painter::probeNineSlice(GtkStyle *style, const QGtkPainterKey &key,
+                                                    const QPixmap &canonical, const QSize &canonicalSize,
+                                                    Qt::Orientations axes, const SizedDrawFunction &draw)
+{
+    NineSlice slice = { false, QMargins() };
+    const QImage image = canonical.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const int width = image.width();
+    const int height = image.height();
+    QSize probeSize = canonicalSize;
+
+    if (axes & Qt::Horizontal) {
+        const int middle = width / 2;
+        int first = middle;
+        int last = middle;
+        while (first > 0 && qt_gtk_columns_equal(image, first - 1, middle))
+            --first;
+        while (last < width - 1 && qt_gtk_columns_equal(image, last + 1, middle))
+            ++last;
+        slice.borders.setLeft(first);
+        slice.borders.setRight(width - 1 - last);
+        probeSize.setWidth(2 * NineSliceExtent);
+    }
+    if (axes & Qt::Vertical) {
+        const int middle = height / 2;
+        int first = middle;
+        int last = middle;
+        while (first > 0 && qt_gtk_rows_equal(image, first - 1, middle))
+            --first;
+        while (last < height - 1 && qt_gtk_rows_equal(image, last + 1, middle))
+            ++last;
+        slice.borders.setTop(first);
+        slice.borders.setBottom(height - 1 - last);
+        probeSize.setHeight(2 * NineSliceExtent);
+    }
+
+    // The probe is a regular render of its size, caching it lets later
+    // processes skip the drawing through the disk cache
+    const QSize probeDeviceSize = deviceSize(probeSize);
+    QGtkPainterKey probeKey = key;
+    probeKey.width = probeSize.width();
+    probeKey.height = probeSize.height();
+    QPixmap probe;
+    if (!QGtkPixmapCache::find(probeKey, &probe)) {
+        probe = renderToPixmap(style, probeKey, probeDeviceSize, [&](GdkPixmap *pixmap, GtkStyle *style,
+                                                           GdkRectangle *area, gint left, gint top) {
+            draw(pixmap, style, area, left, top, probeDeviceSize, GtkStateType(key.state));
+        });
+        if (probe.isNull())
+            return slice;
+        QGtkPixmapCache::insert(probeKey, probe);
+    }
+    const QImage reference = probe.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    const qreal dpr = canonical.devicePixelRatio();
+    const int sx[4] = { 0, slice.borders.left(), width - slice.borders.right(), width };
+    const int sy[4] = { 0, slice.borders.top(), height - slice.borders.bottom(), height };
+    for (int i = 0; i < 3; ++i) {
+        if ((axes & Qt::Vertical) && sy[1] < sy[2])
+            slice.rowTiles[i] = qt_gtk_row_tile(image, sx[i], sx[i + 1] - sx[i], sy[1], dpr);
+        if ((axes & Qt::Horizontal) && sx[1] < sx[2])
+            slice.columnTiles[i] = qt_gtk_column_tile(image, sy[i], sy[i + 1] - sy[i], sx[1], dpr);
+    }
+
+    QImage composed(probeDeviceSize, QImage::Format_ARGB32_Premultiplied);
+    composed.setDevicePixelRatio(m_dpr);
+    composed.fill(Qt::transparent);
+    QPainter painter(&composed);
+    drawNineSlice(&painter, QRect(QPoint(0, 0), probeSize), canonical, slice);
+    painter.end();
+    slice.stretchable = composed == reference;
+    if (!slice.stretchable)
+        slice = { false, slice.borders };
+    return slice;
+}
+
+// Tells whether the render is a single color, which is then returned
+// premultiplied.
+static bool qt_gtk_solid_color(const QPixmap &pixmap, QRgb *color)
+{
+    const QImage image = pixmap.toImage();
+    if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
+        return false;
+
+    const QRgb first = reinterpret_cast<const QRgb *>(image.constScanLine(0))[0];
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            if (line[x] != first)
+                return false;
+        }
+    }
+    *color = image.format() == QImage::Format_RGB32 ? first | 0xff000000 : first;
+    return true;
+}
+
+// Learns from a render of the element of key, which has no size, whether
+// it is a plain fill at every size. A border or gradient may only show
+// from some size on, so a single color render is only believed once a
+// larger one has the same color; any other render rules the element out.
+// Tiny renders say little about other sizes and are not considered.
+void QGtk2Painter::learnSolidColor(const QGtkPainterKey &key, const QPixmap &pixmap)
+{
+    const QSize size = pixmap.size();
+    if (size.width() < 8 || size.height() < 8)
+        return;
+
+    auto it = m_solidCandidates.find(key);
+    if (it != m_solidCandidates.end() && it->rejected)
+        return;
+    QRgb color = 0;
+    const bool solid = qt_gtk_solid_color(pixmap, &color);
+    if (it == m_solidCandidates.end()) {
+        m_solidCandidates.insert(key, { color, size, !solid });
+    } else if (!solid || color != it->color) {
+        it->rejected = true;
+    } else if (size.width() >= it->size.width() && size.height() >= it->size.height() && size != it->size) {
+        m_solidElements.insert(key, color);
+        m_solidCandidates.erase(it);
+    } else if (size.width() * size.height() > it->size.width() * it->size.height()) {
+        it->size = size;
+    }
+}
+
+// Renders the element in every state into one strip, a row per state, so
+// that a single readback also fills the cache for hover, press and the
+// disabled look. The other states are inserted into the cache, the one
+// of key is returned.
+static const GtkStateType qt_gtk_states[] = { GTK_STATE_NORMAL, GTK_STATE_ACTIVE, GTK_STATE_PRELIGHT,
+                                              GTK_STATE_SELECTED, GTK_STATE_INSENSITIVE };
+
+QPixmap QGtk2Painter::renderStates(GtkStyle *style, const QGtkPainterKey &key, const QSize &deviceSize,
+                                   const SizedDrawFunction &draw)
+{
+    const int rowHeight = deviceSize.height();
+    // the opacity learned for the strip holds for all states together
+    QGtkPainterKey stripKey = key;
+    stripKey.state = 0xff;
+    const QPixmap strip = renderToPixmap(style, stripKey, QSize(deviceSize.width(), rowHeight * StateCount),
+                                         [&](GdkPixmap *pixmap, GtkStyle *style, GdkRectangle *area,
+                                             gint left, gint top) {
+        for (int i = 0; i < StateCount; ++i) {
+            GdkRectangle rowArea = { area->x, area->y + i * rowHeight, area->width, rowHeight };
+            draw(pixmap, style, &rowArea, left, top + i * rowHeight, deviceSize, qt_gtk_states[i]);
+        }
+    });
+    if (strip.isNull())
+        return QPixmap();
+
+    QPixmap result;
+    for (int i = 0; i < StateCount; ++i) {
+        // a vertically flipped strip has its rows in reverse order
+        const int row = m_vflipped ? StateCount - 1 - i : i;
+        QPixmap pixmap = strip.copy(0, row * rowHeight, deviceSize.width(), rowHeight);
+        pixmap.setDevicePixelRatio(m_dpr);
+
+        QGtkPainterKey stateKey = key;
+        stateKey.state = qt_gtk_states[i];
+        QGtkPainterKey solidKey = stateKey;
+        solidKey.width = solidKey.height = 0;
+        learnSolidColor(solidKey, pixmap);
+
+        if (stateKey.state == key.state)
+            result = pixmap;
+        else
+            QGtkPixmapCache::insert(stateKey, pixmap);
+    }
+    return result;
+}
+
+// Paints an element of any size, going through a nine-slice of a small
+// canonical render when the element is large and the theme allows it.
+// The size in key is filled in for the cache.
+void QGtk2Painter::paintNineSlice(GtkStyle *style, const QGtkPainterKey &key, const QRect &rect,
+                                  Qt::Orientations axes, const SizedDrawFunction &draw)
+{
+    if (rect.width() > QWIDGETSIZE_MAX || rect.height() > QWIDGETSIZE_MAX)
+        return;
+
+    // key has no size yet, a solid color holds for every size
+    if (m_usePixmapCache) {
+        auto it = m_solidElements.constFind(key);
+        if (it != m_solidElements.constEnd()) {
+            if (qAlpha(*it))
+                m_painter->fillRect(rect, QColor::fromRgba(qUnpremultiply(*it)));
+            return;
+        }
+    }
+
+    Qt::Orientations compressed;
+    QSize canonicalSize = rect.size();
+    if ((axes & Qt::Horizontal) && rect.width() > NineSliceThreshold) {
+        compressed |= Qt::Horizontal;
+        canonicalSize.setWidth(NineSliceExtent);
+    }
+    if ((axes & Qt::Vertical) && rect.height() > NineSliceThreshold) {
+        compressed |= Qt::Vertical;
+        canonicalSize.setHeight(NineSliceExtent);
+    }
+
+    auto render = [&](const QSize &size) {
+        const QSize deviceSize = this->deviceSize(size);
+        // the strip has to fit a scratch drawable including the stacked
+        // white render, or batching would allocate a drawable per miss
+        if (m_batchStates && m_usePixmapCache && deviceSize.width() <= ScratchMaxSize
+                && drawableHeight(style, deviceSize.height() * StateCount) <= ScratchMaxSize
+                && !qt_gtk_style_has_bg_pixmap(style)) {
+            QGtkPainterKey sizedKey = key;
+            sizedKey.width = size.width();
+            sizedKey.height = size.height();
+            return renderStates(style, sizedKey, deviceSize, draw);
+        }
+        const QPixmap rendered = renderToPixmap(style, key, deviceSize, [&](GdkPixmap *pixmap, GtkStyle *style,
+                                                                            GdkRectangle *area, gint left, gint top) {
+            draw(pixmap, style, area, left, top, deviceSize, GtkStateType(key.state));
+        });
+        if (m_usePixmapCache && !rendered.isNull())
+            learnSolidColor(key, rendered);
+        return rendered;
+    };
+
+    QPixmap cache;
+    if (m_usePixmapCache && compressed) {
+        QGtkPainterKey canonicalKey = key;
+        canonicalKey.width = canonicalSize.width();
+        canonicalKey.height = canonicalSize.height();
+        auto it = m_nineSlices.constFind(canonicalKey);
+        if (it == m_nineSlices.constEnd() || it->stretchable) {
+            if (!QGtkPixmapCache::find(canonicalKey, &cache)) {
+                cache = render(canonicalSize);
+                if (cache.isNull())
+                    return;
+                QGtkPixmapCache::insert(canonicalKey, cache);
+            }
+            if (it == m_nineSlices.constEnd()) {
+                if (m_nineSlices.size() >= NineSliceMaxEntries)
+                    m_nineSlices.clear();
+                it = m_nineSlices.insert(canonicalKey, probeNineSlice(style, key, cache, canonicalSize, compressed, draw));
+            }
+            if (it->stretchable) {
+                drawNineSlice(m_painter, rect, cache, *it);
+                return;
+            }
+        }
+    }
+
+    QGtkPainterKey pixmapKey = key;
+    pixmapKey.width = rect.width();
+    pixmapKey.height = rect.height();
+    if (!m_usePixmapCache || !QGtkPixmapCache::find(pixmapKey, &cache)) {
+        cache = render(rect.size());
+        if (cache.isNull())
+            return;
+        if (m_usePixmapCache)
+            QGtkPixmapCache::insert(pixmapKey, cache);
+    }
+    m_painter->drawPixmap(rect.topLeft(), cache);
+}
+
+void QGtk2Painter::clearCaches()
+{
+    m_nineSlices.clear();
+    m_opaqueElements.clear();
+    m_argbRejected.clear();
+    m_solidElements.clear();
+    m_solidCandidates.clear();
+    // widgets may be rebuilt with the theme
+    m_focusWidgets.clear();
+    m_defaultWidget = nullptr;
+    m_widgetDirections.clear();
+    m_rangeAdjustments.clear();
+    releaseScratch();
 }
 
 // This macro is responsible for painting any GtkStyle painting function onto a QPixmap
 #define DRAW_TO_CACHE(draw_func)                                                                    \
     if (rect.width() > QWIDGETSIZE_MAX || rect.height() > QWIDGETSIZE_MAX)                          \
         return;                                                                                     \
-    QRect pixmapRect(0, 0, rect.width(), rect.height());                                            \
-    {                                                                                               \
-        GdkPixmap *pixmap = gdk_pixmap_new((GdkDrawable*)(m_window->window),   \
-                                                                rect.width(), rect.height(), -1);   \
-        if (!pixmap)                                                                                \
-            return;                                                                                 \
-        style = gtk_style_attach (style, m_window->window);                       \
-        gdk_draw_rectangle(pixmap, m_alpha ? style->black_gc : *style->bg_gc,  \
-                                                true, 0, 0, rect.width(), rect.height());           \
+    cache = renderToPixmap(style, pixmapKey, deviceSize(rect.size()), [&](GdkPixmap *pixmap,        \
+                                                                          GtkStyle *style,          \
+                                                                          GdkRectangle *area,       \
+                                                                          gint left, gint top) {    \
         draw_func;                                                                                  \
-        GdkPixbuf *imgb = gdk_pixbuf_new(GDK_COLORSPACE_RGB, true, 8,             \
-                                                           rect.width(), rect.height());            \
-        if (!imgb)                                                                                  \
-            return;                                                                                 \
-        imgb = gdk_pixbuf_get_from_drawable(imgb, pixmap, nullptr, 0, 0, 0, 0,    \
-                                                                 rect.width(), rect.height());      \
-        uchar* bdata = (uchar*)gdk_pixbuf_get_pixels(imgb);                       \
-        if (m_alpha) {                                                                              \
-            gdk_draw_rectangle(pixmap, style->white_gc, true, 0, 0,            \
-                                                    rect.width(), rect.height());                   \
-            draw_func;                                                                              \
-            GdkPixbuf *imgw = gdk_pixbuf_new(GDK_COLORSPACE_RGB, true, 8,         \
-                                                               rect.width(), rect.height());        \
-            if (!imgw)                                                                              \
-                return;                                                                             \
-            imgw = gdk_pixbuf_get_from_drawable(imgw, pixmap, nullptr, 0, 0, 0, 0,\
-                                                                     rect.width(), rect.height());  \
-            uchar* wdata = (uchar*)gdk_pixbuf_get_pixels(imgw);                   \
-            cache = renderTheme(bdata, wdata, rect);                                                \
-            g_object_unref(imgw);                                               \
-        } else {                                                                                    \
-            cache = renderTheme(bdata, nullptr, rect);                                                    \
-        }                                                                                           \
-        gdk_drawable_unref(pixmap);                                            \
-        g_object_unref(imgb);                                                   \
-    }
-
-QGtk2Painter::QGtk2Painter() : QGtkPainter(), m_window(QGtkStylePrivate::gtkWidget("GtkWindow"))
-{}
-
-// Note currently painted without alpha for performance reasons
+    });                                                                                             \
+    if (cache.isNull())                                                                             \
+        return;
+
+// Like DRAW_TO_CACHE, but paints straight to m_painter through paintNineSlice(),
+// draw_func gets the size to paint at in size
+// The state is passed to draw_func, so that all states can be rendered at once
+#define DRAW_NINE_SLICE(pixmapKey, axes, draw_func)                                                 \
+    paintNineSlice(style, pixmapKey, rect, axes, [&](GdkPixmap *pixmap, GtkStyle *style,            \
+                                                      GdkRectangle *area, gint left, gint top,      \
+                                                      const QSize &size, GtkStateType state) {      \
+        draw_func;                                                                                  \
+    });
+
+QGtk2Painter::QGtk2Painter() : QGtkPainter(), m_window(QGtkStylePrivate::gtkWidget(QGtkWidgetId::Window)),
+    m_argbWindow(nullptr), m_argbChecked(false), m_scratchUsed(false)
+{
+    // Reading back both alpha renders at once halves the X round trips,
+    // QT6GTK2_SINGLE_READBACK=0 restores the separate readbacks
+    m_singleReadback = qgetenv("QT6GTK2_SINGLE_READBACK") != "0";
+    // Rendering all states of an element on a miss makes the first hover
+    // and press hit the cache, QT6GTK2_BATCH_STATES=1 enables it
+    m_batchStates = qgetenv("QT6GTK2_BATCH_STATES") == "1";
+
+    m_scratchTimer.setSingleShot(true);
+    QObject::connect(&m_scratchTimer, &QTimer::timeout, &m_scratchTimer, [this] { scratchTimeout(); });
+}
+
 void QGtk2Painter::paintBoxGap(GtkWidget *gtkWidget, const gchar* part,
-                              const QRect &paintRect, GtkStateType state,
+                              const QRect &rect, GtkStateType state,
                               GtkShadowType shadow, GtkPositionType gap_side,
                               gint x, gint width,
                               GtkStyle *style)
 {
-    if (!paintRect.isValid())
+    if (!rect.isValid())
         return;
 
-    QPixmap cache;
-    QRect rect = paintRect;
-
-    // To avoid exhausting cache on large tabframes we cheat a bit by
-    // tiling the center part.
-
-    const int maxHeight = 256;
-    const int border = 16;
-    if (rect.height() > maxHeight && (gap_side == GTK_POS_TOP || gap_side == GTK_POS_BOTTOM))
-        rect.setHeight(2 * border + 1);
-
-    QString pixmapName = uniqueName(QLS(part), state, shadow, rect.size(), gtkWidget)
-                         % HexString<uchar>(gap_side)
-                         % HexString<gint>(width)
-                         % HexString<gint>(x);
-
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
-        DRAW_TO_CACHE(gtk_paint_box_gap (style,
-                                           pixmap,
-                                           state,
-                                           shadow,
-                                           nullptr,
-                                           gtkWidget,
-                                           (const gchar*)part,
-                                           0, 0,
-                                           rect.width(),
-                                           rect.height(),
-                                           gap_side,
-                                           x,
-                                           width));
-        if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
-    }
-    if (rect.size() != paintRect.size()) {
-        // We assume we can stretch the middle tab part
-        // Note: the side effect of this is that pinstripe patterns will get fuzzy
-        const QSize size = cache.size();
-        // top part
-        m_painter->drawPixmap(QRect(paintRect.left(), paintRect.top(),
-                                    paintRect.width(), border), cache,
-                             QRect(0, 0, size.width(), border));
-
-        // tiled center part
-        QPixmap tilePart(cache.width(), 1);
-        QPainter scanLinePainter(&tilePart);
-        scanLinePainter.drawPixmap(QRect(0, 0, tilePart.width(), tilePart.height()), cache, QRect(0, border, size.width(), 1));
-        scanLinePainter.end();
-        m_painter->drawTiledPixmap(QRect(paintRect.left(), paintRect.top() + border,
-                                         paintRect.width(), paintRect.height() - 2*border), tilePart);
-
-        // bottom part
-        m_painter->drawPixmap(QRect(paintRect.left(), paintRect.top() + paintRect.height() - border,
-                                    paintRect.width(), border), cache,
-                             QRect(0, size.height() - border, size.width(), border));
-    } else
-        m_painter->drawPixmap(paintRect.topLeft(), cache);
+    QGtkPainterKey pixmapKey = cacheKey(BoxGap, part, state, shadow, QSize(), gtkWidget);
+    pixmapKey.params[0] = gap_side;
+    pixmapKey.params[1] = width;
+    pixmapKey.params[2] = x;
+
+    // The gap is placed along its side, which therefore must not be stretched
+    const Qt::Orientations axes = gap_side == GTK_POS_TOP || gap_side == GTK_POS_BOTTOM ?
+                Qt::Vertical : Qt::Horizontal;
+    DRAW_NINE_SLICE(pixmapKey, axes,
+                    gtk_paint_box_gap (style,
+                                       pixmap,
+                                       state,
+                                       shadow,
+                                       area,
+                                       gtkWidget,
+                                       (const gchar*)part,
+                                       left, top,
+                                       size.width(),
+                                       size.height(),
+                                       gap_side,
+                                       devicePixels(x),
+                                       devicePixels(width)));
 }
 
 void QGtk2Painter::paintBox(GtkWidget *gtkWidget, const gchar* part,
-                           const QRect &paintRect, GtkStateType state,
+                           const QRect &rect, GtkStateType state,
                            GtkShadowType shadow, GtkStyle *style,
-                           const QString &pmKey)
+                           const QGtkPainterExtra &extra)
 {
-    if (!paintRect.isValid())
+    if (!rect.isValid())
         return;
 
-    QPixmap cache;
-    QRect rect = paintRect;
-
-    // To avoid exhausting cache on large tabframes we cheat a bit by
-    // tiling the center part.
-
-    const int maxHeight = 256;
-    const int maxArea = 256*512;
-    const int border = 32;
-    if (rect.height() > maxHeight && (rect.width()*rect.height() > maxArea))
-        rect.setHeight(2 * border + 1);
-
-    QString pixmapName = uniqueName(QLS(part), state, shadow,
-                                    rect.size(), gtkWidget) % pmKey;
-
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
-        DRAW_TO_CACHE(gtk_paint_box (style,
-                                           pixmap,
-                                           state,
-                                           shadow,
-                                           nullptr,
-                                           gtkWidget,
-                                           part,
-                                           0, 0,
-                                           rect.width(),
-                                           rect.height()));
-        if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
-    }
-    if (rect.size() != paintRect.size()) {
-        // We assume we can stretch the middle tab part
-        // Note: the side effect of this is that pinstripe patterns will get fuzzy
-        const QSize size = cache.size();
-        // top part
-        m_painter->drawPixmap(QRect(paintRect.left(), paintRect.top(),
-                                    paintRect.width(), border), cache,
-                              QRect(0, 0, size.width(), border));
-
-        // tiled center part
-        QPixmap tilePart(cache.width(), 1);
-        QPainter scanLinePainter(&tilePart);
-        scanLinePainter.drawPixmap(QRect(0, 0, tilePart.width(), tilePart.height()), cache, QRect(0, border, size.width(), 1));
-        scanLinePainter.end();
-        m_painter->drawTiledPixmap(QRect(paintRect.left(), paintRect.top() + border,
-                                         paintRect.width(), paintRect.height() - 2*border), tilePart);
-
-        // bottom part
-        m_painter->drawPixmap(QRect(paintRect.left(), paintRect.top() + paintRect.height() - border,
-                                    paintRect.width(), border), cache,
-                              QRect(0, size.height() - border, size.width(), border));
-    } else
-        m_painter->drawPixmap(paintRect.topLeft(), cache);
+    QGtkPainterKey pixmapKey = cacheKey(Box, part, state, shadow, QSize(), gtkWidget, extra);
+    DRAW_NINE_SLICE(pixmapKey, Qt::Horizontal | Qt::Vertical,
+                    gtk_paint_box (style,
+                                   pixmap,
+                                   state,
+                                   shadow,
+                                   area,
+                                   gtkWidget,
+                                   part,
+                                   left, top,
+                                   size.width(),
+                                   size.height()));
 }
 
 void QGtk2Painter::paintHline(GtkWidget *gtkWidget, const gchar* part,
                              const QRect &rect, GtkStateType state,
                              GtkStyle *style, int x1, int x2, int y,
-                             const QString &pmKey)
+                             const QGtkPainterExtra &extra)
 {
     if (!rect.isValid())
         return;
 
     QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, GTK_SHADOW_NONE, rect.size(), gtkWidget)
-                         % HexString<int>(x1)
-                         % HexString<int>(x2)
-                         % HexString<int>(y)
-                         % pmKey;
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
+    QGtkPainterKey pixmapKey = cacheKey(Hline, part, state, GTK_SHADOW_NONE, rect.size(), gtkWidget, extra);
+    pixmapKey.params[0] = x1;
+    pixmapKey.params[1] = x2;
+    pixmapKey.params[2] = y;
+    if (!m_usePixmapCache || !QGtkPixmapCache::find(pixmapKey, &cache)) {
         DRAW_TO_CACHE(gtk_paint_hline (style,
                                          pixmap,
                                          state,
-                                         nullptr,
+                                         area,
                                          gtkWidget,
                                          part,
-                                         x1, x2, y));
+                                         left + devicePixels(x1), left + devicePixels(x2),
+                                         top + devicePixels(y)));
         if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
+            QGtkPixmapCache::insert(pixmapKey, cache);
     }
 
     m_painter->drawPixmap(rect.topLeft(), cache);
@@ -268,29 +949,28 @@ void QGtk2Painter::paintHline(GtkWidget *gtkWidget, const gchar* part,
 void QGtk2Painter::paintVline(GtkWidget *gtkWidget, const gchar* part,
                              const QRect &rect, GtkStateType state,
                              GtkStyle *style, int y1, int y2, int x,
-                             const QString &pmKey)
+                             const QGtkPainterExtra &extra)
 {
     if (!rect.isValid())
         return;
 
     QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, GTK_SHADOW_NONE, rect.size(), gtkWidget)
-                        % HexString<int>(y1)
-                        % HexString<int>(y2)
-                        % HexString<int>(x)
-                        % pmKey;
+    QGtkPainterKey pixmapKey = cacheKey(Vline, part, state, GTK_SHADOW_NONE, rect.size(), gtkWidget, extra);
+    pixmapKey.params[0] = y1;
+    pixmapKey.params[1] = y2;
+    pixmapKey.params[2] = x;
 
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
+    if (!m_usePixmapCache || !QGtkPixmapCache::find(pixmapKey, &cache)) {
         DRAW_TO_CACHE(gtk_paint_vline (style,
                                          pixmap,
                                          state,
-                                         nullptr,
+                                         area,
                                          gtkWidget,
                                          part,
-                                         y1, y2,
-                                         x));
+                                         top + devicePixels(y1), top + devicePixels(y2),
+                                         left + devicePixels(x)));
         if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
+            QGtkPixmapCache::insert(pixmapKey, cache);
     }
     m_painter->drawPixmap(rect.topLeft(), cache);
 }
@@ -299,72 +979,68 @@ void QGtk2Painter::paintVline(GtkWidget *gtkWidget, const gchar* part,
 void QGtk2Painter::paintExpander(GtkWidget *gtkWidget,
                                 const gchar* part, const QRect &rect,
                                 GtkStateType state, GtkExpanderStyle expander_state,
-                                GtkStyle *style, const QString &pmKey)
+                                GtkStyle *style, const QGtkPainterExtra &extra)
 {
     if (!rect.isValid())
         return;
 
     QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, GTK_SHADOW_NONE, rect.size(), gtkWidget)
-                         % HexString<uchar>(expander_state)
-                         % pmKey;
+    QRect source;
+    QGtkPainterKey pixmapKey = cacheKey(Expander, part, state, GTK_SHADOW_NONE, rect.size(), gtkWidget, extra);
+    pixmapKey.params[0] = expander_state;
 
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
+    if (!m_usePixmapCache || !QGtkPixmapCache::findTile(pixmapKey, &cache, &source)) {
         DRAW_TO_CACHE(gtk_paint_expander (style, pixmap,
-                                            state, nullptr,
+                                            state, area,
                                             gtkWidget, part,
-                                            rect.width()/2,
-                                            rect.height()/2,
+                                            left + devicePixels(rect.width())/2,
+                                            top + devicePixels(rect.height())/2,
                                             expander_state));
+        source = cache.rect();
         if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
+            QGtkPixmapCache::insertTile(pixmapKey, cache);
     }
 
-    m_painter->drawPixmap(rect.topLeft(), cache);
+    m_painter->drawPixmap(rect, cache, source);
 }
 
 void QGtk2Painter::paintFocus(GtkWidget *gtkWidget, const gchar* part,
                              const QRect &rect, GtkStateType state,
-                             GtkStyle *style, const QString &pmKey)
+                             GtkStyle *style, const QGtkPainterExtra &extra)
 {
     if (!rect.isValid())
         return;
 
-    QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, GTK_SHADOW_NONE, rect.size(), gtkWidget) % pmKey;
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
-        DRAW_TO_CACHE(gtk_paint_focus (style, pixmap, state, nullptr,
-                                         gtkWidget,
-                                         part,
-                                         0, 0,
-                                         rect.width(),
-                                         rect.height()));
-        if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
-    }
-
-    m_painter->drawPixmap(rect.topLeft(), cache);
+    QGtkPainterKey pixmapKey = cacheKey(Focus, part, state, GTK_SHADOW_NONE, QSize(), gtkWidget, extra);
+    DRAW_NINE_SLICE(pixmapKey, Qt::Horizontal | Qt::Vertical,
+                    gtk_paint_focus (style, pixmap, state, area,
+                                     gtkWidget,
+                                     part,
+                                     left, top,
+                                     size.width(),
+                                     size.height()));
 }
 
 
 void QGtk2Painter::paintResizeGrip(GtkWidget *gtkWidget, const gchar* part,
                                   const QRect &rect, GtkStateType state,
                                   GtkShadowType shadow, GdkWindowEdge edge,
-                                  GtkStyle *style, const QString &pmKey)
+                                  GtkStyle *style, const QGtkPainterExtra &extra)
 {
     if (!rect.isValid())
         return;
 
     QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, shadow, rect.size(), gtkWidget) % pmKey;
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
+    QGtkPainterKey pixmapKey = cacheKey(ResizeGrip, part, state, shadow, rect.size(), gtkWidget, extra);
+    pixmapKey.params[0] = edge;
+    if (!m_usePixmapCache || !QGtkPixmapCache::find(pixmapKey, &cache)) {
         DRAW_TO_CACHE(gtk_paint_resize_grip (style, pixmap, state,
-                                               nullptr, gtkWidget,
-                                               part, edge, 0, 0,
-                                               rect.width(),
-                                               rect.height()));
+                                               area, gtkWidget,
+                                               part, edge, left, top,
+                                               devicePixels(rect.width()),
+                                               devicePixels(rect.height())));
         if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
+            QGtkPixmapCache::insert(pixmapKey, cache);
     }
 
     m_painter->drawPixmap(rect.topLeft(), cache);
@@ -374,34 +1050,36 @@ void QGtk2Painter::paintResizeGrip(GtkWidget *gtkWidget, const gchar* part,
 void QGtk2Painter::paintArrow(GtkWidget *gtkWidget, const gchar* part,
                              const QRect &arrowrect, GtkArrowType arrow_type,
                              GtkStateType state, GtkShadowType shadow,
-                             gboolean fill, GtkStyle *style, const QString &pmKey)
+                             gboolean fill, GtkStyle *style, const QGtkPainterExtra &extra)
 {
     QRect rect = m_cliprect.isValid() ? m_cliprect : arrowrect;
     if (!rect.isValid())
         return;
 
     QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, shadow, rect.size())
-                         % HexString<uchar>(arrow_type)
-                         % pmKey;
-
-    GdkRectangle gtkCliprect = {0, 0, rect.width(), rect.height()};
+    QRect source;
     int xOffset = m_cliprect.isValid() ? arrowrect.x() - m_cliprect.x() : 0;
     int yOffset = m_cliprect.isValid() ? arrowrect.y() - m_cliprect.y() : 0;
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
+    QGtkPainterKey pixmapKey = cacheKey(Arrow, part, state, shadow, rect.size(), nullptr, extra);
+    pixmapKey.params[0] = arrow_type;
+    pixmapKey.params[1] = fill;
+    pixmapKey.params[2] = xOffset;
+    pixmapKey.params[3] = yOffset;
+    if (!m_usePixmapCache || !QGtkPixmapCache::findTile(pixmapKey, &cache, &source)) {
         DRAW_TO_CACHE(gtk_paint_arrow (style, pixmap, state, shadow,
-                                         &gtkCliprect,
+                                         area,
                                          gtkWidget,
                                          part,
                                          arrow_type, fill,
-                                         xOffset, yOffset,
-                                         arrowrect.width(),
-                                         arrowrect.height()))
+                                         left + devicePixels(xOffset), top + devicePixels(yOffset),
+                                         devicePixels(arrowrect.width()),
+                                         devicePixels(arrowrect.height())))
+        source = cache.rect();
         if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
+            QGtkPixmapCache::insertTile(pixmapKey, cache);
     }
 
-    m_painter->drawPixmap(rect.topLeft(), cache);
+    m_painter->drawPixmap(rect, cache, source);
 }
 
 
@@ -413,22 +1091,22 @@ void QGtk2Painter::paintHandle(GtkWidget *gtkWidget, const gchar* part, const QR
         return;
 
     QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, shadow, rect.size())
-                         % HexString<uchar>(orientation);
+    QGtkPainterKey pixmapKey = cacheKey(Handle, part, state, shadow, rect.size());
+    pixmapKey.params[0] = orientation;
 
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
+    if (!m_usePixmapCache || !QGtkPixmapCache::find(pixmapKey, &cache)) {
         DRAW_TO_CACHE(gtk_paint_handle (style,
                                           pixmap,
                                           state,
                                           shadow,
-                                          nullptr,
+                                          area,
                                           gtkWidget,
-                                          part, 0, 0,
-                                          rect.width(),
-                                          rect.height(),
+                                          part, left, top,
+                                          devicePixels(rect.width()),
+                                          devicePixels(rect.height()),
                                           orientation));
         if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
+            QGtkPixmapCache::insert(pixmapKey, cache);
     }
     m_painter->drawPixmap(rect.topLeft(), cache);
 }
@@ -437,75 +1115,61 @@ void QGtk2Painter::paintHandle(GtkWidget *gtkWidget, const gchar* part, const QR
 void QGtk2Painter::paintSlider(GtkWidget *gtkWidget, const gchar* part, const QRect &rect,
                               GtkStateType state, GtkShadowType shadow,
                               GtkStyle *style, GtkOrientation orientation,
-                              const QString &pmKey)
+                              const QGtkPainterExtra &extra)
 {
     if (!rect.isValid())
         return;
 
-    QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, shadow, rect.size(), gtkWidget) % pmKey;
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
-        DRAW_TO_CACHE(gtk_paint_slider (style,
-                                          pixmap,
-                                          state,
-                                          shadow,
-                                          nullptr,
-                                          gtkWidget,
-                                          part,
-                                          0, 0,
-                                          rect.width(),
-                                          rect.height(),
-                                          orientation));
-        if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
-    }
-    m_painter->drawPixmap(rect.topLeft(), cache);
+    QGtkPainterKey pixmapKey = cacheKey(Slider, part, state, shadow, QSize(), gtkWidget, extra);
+    pixmapKey.params[0] = orientation;
+    DRAW_NINE_SLICE(pixmapKey, Qt::Horizontal | Qt::Vertical,
+                    gtk_paint_slider (style,
+                                      pixmap,
+                                      state,
+                                      shadow,
+                                      area,
+                                      gtkWidget,
+                                      part,
+                                      left, top,
+                                      size.width(),
+                                      size.height(),
+                                      orientation));
 }
 
 
 void QGtk2Painter::paintShadow(GtkWidget *gtkWidget, const gchar* part,
                               const QRect &rect, GtkStateType state,
                               GtkShadowType shadow, GtkStyle *style,
-                              const QString &pmKey)
+                              const QGtkPainterExtra &extra)
 
 {
     if (!rect.isValid())
         return;
 
-    QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, shadow, rect.size()) % pmKey;
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
-        DRAW_TO_CACHE(gtk_paint_shadow(style, pixmap, state, shadow, nullptr,
-                                         gtkWidget, part, 0, 0, rect.width(), rect.height()));
-        if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
-    }
-    m_painter->drawPixmap(rect.topLeft(), cache);
+    QGtkPainterKey pixmapKey = cacheKey(Shadow, part, state, shadow, QSize(), nullptr, extra);
+    DRAW_NINE_SLICE(pixmapKey, Qt::Horizontal | Qt::Vertical,
+                    gtk_paint_shadow(style, pixmap, state, shadow, area,
+                                     gtkWidget, part, left, top, size.width(), size.height()));
 }
 
 void QGtk2Painter::paintFlatBox(GtkWidget *gtkWidget, const gchar* part,
                                const QRect &rect, GtkStateType state,
                                GtkShadowType shadow, GtkStyle *style,
-                               const QString &pmKey)
+                               const QGtkPainterExtra &extra)
 {
     if (!rect.isValid())
         return;
-    QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, shadow, rect.size()) % pmKey;
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
-        DRAW_TO_CACHE(gtk_paint_flat_box (style,
-                                            pixmap,
-                                            state,
-                                            shadow,
-                                            nullptr,
-                                            gtkWidget,
-                                            part, 0, 0,
-                                            rect.width(),
-                                            rect.height()));
-        if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
-    }
-    m_painter->drawPixmap(rect.topLeft(), cache);
+    QGtkPainterKey pixmapKey = cacheKey(FlatBox, part, state, shadow, QSize(), nullptr, extra);
+    DRAW_NINE_SLICE(pixmapKey, Qt::Horizontal | Qt::Vertical,
+                    gtk_paint_flat_box (style,
+                                        pixmap,
+                                        state,
+                                        shadow,
+                                        area,
+                                        gtkWidget,
+                                        part, left, top,
+                                        size.width(),
+                                        size.height()));
 }
 
 void QGtk2Painter::paintExtention(GtkWidget *gtkWidget,
@@ -516,27 +1180,20 @@ void QGtk2Painter::paintExtention(GtkWidget *gtkWidget,
     if (!rect.isValid())
         return;
 
-    QPixmap cache;
-    QString pixmapName = uniqueName(QLS(part), state, shadow, rect.size(), gtkWidget)
-                         % HexString<uchar>(gap_pos);
-
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
-        DRAW_TO_CACHE(gtk_paint_extension (style, pixmap, state, shadow,
-                                             nullptr, gtkWidget,
-                                             (const gchar*)part, 0, 0,
-                                             rect.width(),
-                                             rect.height(),
-                                             gap_pos));
-        if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
-    }
-
-    m_painter->drawPixmap(rect.topLeft(), cache);
+    QGtkPainterKey pixmapKey = cacheKey(Extension, part, state, shadow, QSize(), gtkWidget);
+    pixmapKey.params[0] = gap_pos;
+    DRAW_NINE_SLICE(pixmapKey, Qt::Horizontal | Qt::Vertical,
+                    gtk_paint_extension (style, pixmap, state, shadow,
+                                         area, gtkWidget,
+                                         (const gchar*)part, left, top,
+                                         size.width(),
+                                         size.height(),
+                                         gap_pos));
 }
 
 void QGtk2Painter::paintOption(GtkWidget *gtkWidget, const QRect &radiorect,
                               GtkStateType state, GtkShadowType shadow,
-                              GtkStyle *style, const QString &detail)
+                              GtkStyle *style, const gchar *detail)
 
 {
     QRect rect = m_cliprect.isValid() ? m_cliprect : radiorect;
@@ -544,30 +1201,35 @@ void QGtk2Painter::paintOption(GtkWidget *gtkWidget, const QRect &radiorect,
         return;
 
     QPixmap cache;
-    QString pixmapName = uniqueName(detail, state, shadow, rect.size());
-    GdkRectangle gtkCliprect = {0, 0, rect.width(), rect.height()};
+    QRect source;
     int xOffset = m_cliprect.isValid() ? radiorect.x() - m_cliprect.x() : 0;
     int yOffset = m_cliprect.isValid() ? radiorect.y() - m_cliprect.y() : 0;
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
+    QGtkPainterKey pixmapKey = cacheKey(Option, detail, state, shadow, rect.size(), nullptr);
+    pixmapKey.params[0] = xOffset;
+    pixmapKey.params[1] = yOffset;
+    pixmapKey.params[2] = radiorect.width();
+    pixmapKey.params[3] = radiorect.height();
+    if (!m_usePixmapCache || !QGtkPixmapCache::findTile(pixmapKey, &cache, &source)) {
         DRAW_TO_CACHE(gtk_paint_option(style, pixmap,
                                          state, shadow,
-                                         &gtkCliprect,
+                                         area,
                                          gtkWidget,
-                                         detail.toLatin1().constData(),
-                                         xOffset, yOffset,
-                                         radiorect.width(),
-                                         radiorect.height()));
+                                         detail,
+                                         left + devicePixels(xOffset), top + devicePixels(yOffset),
+                                         devicePixels(radiorect.width()),
+                                         devicePixels(radiorect.height())));
 
+        source = cache.rect();
         if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
+            QGtkPixmapCache::insertTile(pixmapKey, cache);
     }
 
-    m_painter->drawPixmap(rect.topLeft(), cache);
+    m_painter->drawPixmap(rect, cache, source);
 }
 
 void QGtk2Painter::paintCheckbox(GtkWidget *gtkWidget, const QRect &checkrect,
                                 GtkStateType state, GtkShadowType shadow,
-                                GtkStyle *style, const QString &detail)
+                                GtkStyle *style, const gchar *detail)
 
 {
     QRect rect = m_cliprect.isValid() ? m_cliprect : checkrect;
@@ -575,26 +1237,31 @@ void QGtk2Painter::paintCheckbox(GtkWidget *gtkWidget, const QRect &checkrect,
         return;
 
     QPixmap cache;
-    QString pixmapName = uniqueName(detail, state, shadow, rect.size());
-    GdkRectangle gtkCliprect = {0, 0, rect.width(), rect.height()};
+    QRect source;
     int xOffset = m_cliprect.isValid() ? checkrect.x() - m_cliprect.x() : 0;
     int yOffset = m_cliprect.isValid() ? checkrect.y() - m_cliprect.y() : 0;
-    if (!m_usePixmapCache || !QPixmapCache::find(pixmapName, &cache)) {
+    QGtkPainterKey pixmapKey = cacheKey(Checkbox, detail, state, shadow, rect.size(), nullptr);
+    pixmapKey.params[0] = xOffset;
+    pixmapKey.params[1] = yOffset;
+    pixmapKey.params[2] = checkrect.width();
+    pixmapKey.params[3] = checkrect.height();
+    if (!m_usePixmapCache || !QGtkPixmapCache::findTile(pixmapKey, &cache, &source)) {
         DRAW_TO_CACHE(gtk_paint_check (style,
                                          pixmap,
                                          state,
                                          shadow,
-                                         &gtkCliprect,
+                                         area,
                                          gtkWidget,
-                                         detail.toLatin1().constData(),
-                                         xOffset, yOffset,
-                                         checkrect.width(),
-                                         checkrect.height()));
+                                         detail,
+                                         left + devicePixels(xOffset), top + devicePixels(yOffset),
+                                         devicePixels(checkrect.width()),
+                                         devicePixels(checkrect.height())));
+        source = cache.rect();
         if (m_usePixmapCache)
-            QPixmapCache::insert(pixmapName, cache);
+            QGtkPixmapCache::insertTile(pixmapKey, cache);
     }
 
-    m_painter->drawPixmap(rect.topLeft(), cache);
+    m_painter->drawPixmap(rect, cache, source);
 }
 
 QT_END_NAMESPACE
@@ -35,6 +35,12 @@
 #include <QtGlobal>
 #if !defined(QT_NO_STYLE_GTK)
 
+#include <functional>
+#include <QHash>
+#include <QList>
+#include <QMargins>
+#include <QSet>
+#include <QTimer>
 #include "qgtkpainter_p.h"
 
 QT_BEGIN_NAMESPACE
@@ -49,35 +55,104 @@ public:
                      gint width, GtkStyle *style) override;
     void paintBox(GtkWidget *gtkWidget, const gchar* part,
                   const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style,
-                  const QString &pmKey = QString()) override;
+                  const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
     void paintHline(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkStyle *style,
-                    int x1, int x2, int y, const QString &pmKey = QString()) override;
+                    int x1, int x2, int y, const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
     void paintVline(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkStyle *style,
-                    int y1, int y2, int x, const QString &pmKey = QString()) override;
+                    int y1, int y2, int x, const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
     void paintExpander(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state,
-                       GtkExpanderStyle expander_state, GtkStyle *style, const QString &pmKey = QString()) override;
+                       GtkExpanderStyle expander_state, GtkStyle *style, const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
     void paintFocus(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkStyle *style,
-                    const QString &pmKey = QString()) override;
+                    const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
     void paintResizeGrip(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow,
-                         GdkWindowEdge edge, GtkStyle *style, const QString &pmKey = QString()) override;
+                         GdkWindowEdge edge, GtkStyle *style, const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
     void paintArrow(GtkWidget *gtkWidget, const gchar* part, const QRect &arrowrect, GtkArrowType arrow_type, GtkStateType state, GtkShadowType shadow,
-                    gboolean fill, GtkStyle *style, const QString &pmKey = QString()) override;
+                    gboolean fill, GtkStyle *style, const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
     void paintHandle(GtkWidget *gtkWidget, const gchar* part, const QRect &rect,
                      GtkStateType state, GtkShadowType shadow, GtkOrientation orientation, GtkStyle *style) override;
     void paintSlider(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow,
-                     GtkStyle *style, GtkOrientation orientation, const QString &pmKey = QString()) override;
+                     GtkStyle *style, GtkOrientation orientation, const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
     void paintShadow(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow,
-                     GtkStyle *style, const QString &pmKey = QString()) override;
-    void paintFlatBox(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const QString & = QString()) override;
+                     GtkStyle *style, const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
+    void paintFlatBox(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style,
+                      const QGtkPainterExtra &extra = QGtkPainterExtra()) override;
     void paintExtention(GtkWidget *gtkWidget, const gchar *part, const QRect &rect, GtkStateType state, GtkShadowType shadow,
                         GtkPositionType gap_pos, GtkStyle *style) override;
-    void paintOption(GtkWidget *gtkWidget, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const QString &detail) override;
-    void paintCheckbox(GtkWidget *gtkWidget, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const QString &detail) override;
+    void paintOption(GtkWidget *gtkWidget, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const gchar *detail) override;
+    void paintCheckbox(GtkWidget *gtkWidget, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const gchar *detail) override;
+
+    void clearCaches() override;
 
 private:
-    QPixmap renderTheme(uchar *bdata, uchar *wdata, const QRect &rect) const;
+    // Paints the element with its top left corner at (left, top), clipped to area
+    typedef std::function<void(GdkPixmap *pixmap, GtkStyle *style, GdkRectangle *area,
+                               gint left, gint top)> DrawFunction;
+
+    // Like DrawFunction, for elements that can be painted at various sizes
+    // and states, size is in device pixels
+    typedef std::function<void(GdkPixmap *pixmap, GtkStyle *style, GdkRectangle *area,
+                               gint left, gint top, const QSize &size, GtkStateType state)> SizedDrawFunction;
+
+    struct NineSlice
+    {
+        bool stretchable;
+        QMargins borders; // in device pixels
+        QPixmap rowTiles[3];    // left, middle and right of a middle row
+        QPixmap columnTiles[3]; // top, middle and bottom of a middle column
+    };
+
+    // The first single color render of an element, waiting for a larger
+    // one to agree
+    struct SolidCandidate
+    {
+        QRgb color;
+        QSize size;
+        bool rejected; // some render of the element was not of one color
+    };
+
+    // A drawable kept for renders up to its size class
+    struct ScratchPixmap
+    {
+        GdkWindow *window;
+        QSize size;
+        GdkPixmap *pixmap;
+    };
+
+    QPixmap renderToPixmap(GtkStyle *style, const QGtkPainterKey &key, const QSize &size, const DrawFunction &draw);
+    void applyWidgetState();
+    void restoreWidgetState();
+    int drawableHeight(GtkStyle *style, int height) const;
+    QPixmap renderToDefaultPixmap(GtkStyle *style, const QSize &size, const DrawFunction &draw) const;
+    QPixmap renderToArgbPixmap(GtkStyle *style, const QSize &size, const DrawFunction &draw) const;
+    GtkWidget *argbWindow();
+    bool verifyArgbRendering();
+    QPixmap renderTheme(uchar *bdata, const uchar *wdata, const QSize &size) const;
+    GdkPixmap *scratchPixmap(GdkWindow *window, const QSize &size) const;
+    void scratchTimeout() const;
+    void releaseScratch() const;
+    void learnSolidColor(const QGtkPainterKey &key, const QPixmap &pixmap);
+    QPixmap renderStates(GtkStyle *style, const QGtkPainterKey &key, const QSize &deviceSize,
+                         const SizedDrawFunction &draw);
+    static void drawNineSlice(QPainter *painter, const QRect &rect, const QPixmap &pixmap, const NineSlice &slice);
+    void paintNineSlice(GtkStyle *style, const QGtkPainterKey &key, const QRect &rect,
+                        Qt::Orientations axes, const SizedDrawFunction &draw);
+    NineSlice probeNineSlice(GtkStyle *style, const QGtkPainterKey &key, const QPixmap &canonical,
+                             const QSize &canonicalSize, Qt::Orientations axes, const SizedDrawFunction &draw);
 
     GtkWidget *m_window;
+    GtkWidget *m_argbWindow;
+    bool m_argbChecked;
+    bool m_singleReadback;
+    bool m_batchStates;
+    QHash<QGtkPainterKey, NineSlice> m_nineSlices;
+    QHash<QGtkPainterKey, bool> m_opaqueElements; // by key without size, scale, alpha and flips
+    QSet<QGtkPainterKey> m_argbRejected; // by the same key, differed in ARGB
+    QHash<QGtkPainterKey, QRgb> m_solidElements; // premultiplied, by key without size
+    QHash<QGtkPainterKey, SolidCandidate> m_solidCandidates; // by key without size
+    mutable QList<ScratchPixmap> m_scratchPixmaps;
+    mutable QByteArray m_whiteBuffer;
+    mutable QTimer m_scratchTimer;
+    mutable bool m_scratchUsed;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,341 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "qgtkdiskcache_p.h"
+
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDir>
+#include <QDirIterator>
+#include <QHash>
+#include <QImage>
+#include "qgtkstyle_p_p.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// File layout: header, index entries, then the pixels of each entry
+// with width * 4 byte rows, all in native byte order
+struct QGtkDiskCacheHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 count;
+    quint64 stamp;
+};
+
+struct QGtkDiskCacheEntry
+{
+    QGtkStableKey key;
+    quint64 offset;
+    qint32 width;
+    qint32 height;
+    quint32 format;
+    quint32 reserved;
+};
+
+static const char qt_gtk_cache_magic[8] = { 'Q', 'T', '6', 'G', 'T', 'K', '2', 'C' };
+// Bump when QGtkPainterKey, the rendering or the file layout change
+static const quint32 qt_gtk_cache_version = 2;
+// New renders are not written once the file would grow past this size
+static const qint64 qt_gtk_cache_max_size = 32 * 1024 * 1024;
+
+struct QGtkDiskCacheData
+{
+    QGtkDiskCacheData()
+        : enabled(qgetenv("QT6GTK2_DISK_CACHE") != "0")
+    {
+        qAddPostRoutine(QGtkDiskCache::flush);
+    }
+
+    bool open();
+    void close();
+
+    bool enabled;
+    bool opened = false;
+    bool valid = false;
+    bool stamped = false;
+    quint64 stamp = 0;
+    QString fileName;
+    QFile file;
+    const uchar *data = nullptr;
+    qint64 size = 0;
+    QHash<QGtkStableKey, const QGtkDiskCacheEntry *> index;
+    QHash<QGtkStableKey, QImage> pending;
+    qint64 pendingSize = 0;
+};
+
+}
+
+Q_GLOBAL_STATIC(QGtkDiskCacheData, diskCache)
+
+static quint64 qt_gtk_hash_file(const QString &path, quint64 hash)
+{
+    const QFileInfo info(path);
+    if (!info.exists())
+        return hash;
+    const QByteArray name = QFile::encodeName(path);
+    const qint64 stamps[2] = { info.lastModified().toMSecsSinceEpoch(), info.size() };
+    hash = qt_gtk_stable_hash(name.constData(), name.size(), hash);
+    return qt_gtk_stable_hash(stamps, sizeof(stamps), hash);
+}
+
+// Hashes every file below dir, such as the rc files a theme includes
+// and the images of the pixmap engine
+static quint64 qt_gtk_hash_dir(const QString &dir, quint64 hash)
+{
+    QStringList files;
+    QDirIterator it(dir, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        files.append(it.next());
+    files.sort();
+    for (const QString &file : std::as_const(files))
+        hash = qt_gtk_hash_file(file, hash);
+    return hash;
+}
+
+// Name of the engine module that draws style, if any
+static QByteArray qt_gtk_engine_name(GtkStyle *style)
+{
+    for (GType type = style ? G_OBJECT_TYPE(style) : 0; type && type != GTK_TYPE_STYLE; type = g_type_parent(type)) {
+        GTypePlugin *plugin = g_type_get_plugin(type);
+        if (plugin && G_IS_TYPE_MODULE(plugin))
+            return QByteArray(G_TYPE_MODULE(plugin)->name);
+    }
+    return QByteArray();
+}
+
+// Identifies what the renders depend on: the theme and its files, the
+// engine module, the gtkrc files, the color scheme and the font
+static quint64 qt_gtk_cache_stamp(const QString &themeName)
+{
+    const QByteArray theme = themeName.toUtf8();
+    quint64 hash = qt_gtk_stable_hash(&qt_gtk_cache_version, sizeof(qt_gtk_cache_version));
+    hash = qt_gtk_stable_hash(theme.constData(), theme.size(), hash);
+
+    for (gchar **files = gtk_rc_get_default_files(); files && *files; ++files)
+        hash = qt_gtk_hash_file(QFile::decodeName(*files), hash);
+
+    gchar *themeDir = gtk_rc_get_theme_dir();
+    const QString subPath = QLatin1Char('/') + themeName + QLatin1String("/gtk-2.0");
+    hash = qt_gtk_hash_dir(QFile::decodeName(themeDir) + subPath, hash);
+    hash = qt_gtk_hash_dir(QDir::homePath() + QLatin1String("/.themes") + subPath, hash);
+    g_free(themeDir);
+
+    const QByteArray engine = qt_gtk_engine_name(QGtkStylePrivate::gtkStyle());
+    if (!engine.isEmpty()) {
+        hash = qt_gtk_stable_hash(engine.constData(), engine.size(), hash);
+        if (gchar *module = gtk_rc_find_module_in_path(engine.constData())) {
+            hash = qt_gtk_hash_file(QFile::decodeName(module), hash);
+            g_free(module);
+        }
+    }
+
+    // Set through XSETTINGS or a gtkrc, the theme colors derive from it
+    gchar *colorScheme = nullptr;
+    g_object_get(gtk_settings_get_default(), "gtk-color-scheme", &colorScheme, nullptr);
+    if (colorScheme) {
+        hash = qt_gtk_stable_hash(colorScheme, strlen(colorScheme), hash);
+        g_free(colorScheme);
+    }
+
+    const QByteArray font = QGtkStylePrivate::getThemeFont().toString().toUtf8();
+    return qt_gtk_stable_hash(font.constData(), font.size(), hash);
+}
+
+bool QGtkDiskCacheData::open()
+{
+    if (opened)
+        return valid;
+    opened = true;
+    if (!enabled)
+        return false;
+
+    const QString themeName = QGtkStylePrivate::getThemeName();
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+            + QLatin1String("/qt6gtk2");
+    if (themeName.isEmpty() || !QDir().mkpath(dir))
+        return false;
+    fileName = dir + QLatin1Char('/') + QString(themeName).replace(QLatin1Char('/'), QLatin1Char('_'))
+            + QLatin1String(".cache");
+    stamp = QGtkDiskCache::themeStamp();
+    valid = true;
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(QGtkDiskCacheHeader)))
+        return true;
+    size = file.size();
+    data = file.map(0, size);
+    if (!data)
+        return true;
+
+    // A cache of another theme state or version is stale, it gets rewritten on flush()
+    const QGtkDiskCacheHeader *header = reinterpret_cast<const QGtkDiskCacheHeader *>(data);
+    if (memcmp(header->magic, qt_gtk_cache_magic, sizeof(header->magic)) || header->version != qt_gtk_cache_version
+            || header->stamp != stamp
+            || header->count > quint64(size - sizeof(QGtkDiskCacheHeader)) / sizeof(QGtkDiskCacheEntry)) {
+        close();
+        return true;
+    }
+
+    // find() trusts what lands in the index, so entries that would read
+    // past the file or in another pixel layout are dropped here
+    const QGtkDiskCacheEntry *entries = reinterpret_cast<const QGtkDiskCacheEntry *>(header + 1);
+    const quint64 pixelsStart = sizeof(QGtkDiskCacheHeader) + quint64(header->count) * sizeof(QGtkDiskCacheEntry);
+    for (quint32 i = 0; i < header->count; ++i) {
+        const QGtkDiskCacheEntry &entry = entries[i];
+        if (entry.format != QImage::Format_RGB32 && entry.format != QImage::Format_ARGB32_Premultiplied)
+            continue;
+        if (entry.width <= 0 || entry.height <= 0 || entry.width > 0x3fffffff / 4
+                || entry.offset < pixelsStart || entry.offset % 4 || entry.offset > quint64(size)
+                || quint64(entry.width) * quint64(entry.height) * 4 > quint64(size) - entry.offset)
+            continue;
+        index.insert(entry.key, &entry);
+    }
+    return true;
+}
+
+void QGtkDiskCacheData::close()
+{
+    index.clear();
+    if (data)
+        file.unmap(const_cast<uchar *>(data));
+    data = nullptr;
+    size = 0;
+    file.close();
+}
+
+bool QGtkDiskCache::find(const QGtkPainterKey &key, QPixmap *pixmap)
+{
+    QGtkDiskCacheData *d = diskCache();
+    if (!d->open() || d->index.isEmpty())
+        return false;
+
+    const QGtkDiskCacheEntry *entry = d->index.value(QGtkPainter::stableKey(key));
+    if (!entry)
+        return false;
+
+    const QImage image(d->data + entry->offset, entry->width, entry->height, entry->width * 4,
+                       QImage::Format(entry->format));
+    *pixmap = QPixmap::fromImage(image);
+    pixmap->setDevicePixelRatio(key.dpr / 100.0);
+    return !pixmap->isNull();
+}
+
+void QGtkDiskCache::insert(const QGtkPainterKey &key, const QPixmap &pixmap)
+{
+    QGtkDiskCacheData *d = diskCache();
+    if (!d->open())
+        return;
+
+    QImage image = pixmap.toImage();
+    if (image.format() != QImage::Format_RGB32)
+        image.convertTo(QImage::Format_ARGB32_Premultiplied);
+    const qint64 bytes = qint64(image.width()) * image.height() * 4;
+    if (d->size + d->pendingSize + bytes > qt_gtk_cache_max_size)
+        return;
+
+    const QGtkStableKey stable = QGtkPainter::stableKey(key);
+    if (d->index.contains(stable) || d->pending.contains(stable))
+        return;
+    d->pending.insert(stable, image);
+    d->pendingSize += bytes;
+}
+
+quint64 QGtkDiskCache::themeStamp()
+{
+    QGtkDiskCacheData *d = diskCache();
+    if (!d->stamped) {
+        d->stamp = qt_gtk_cache_stamp(QGtkStylePrivate::getThemeName());
+        d->stamped = true;
+    }
+    return d->stamp;
+}
+
+void QGtkDiskCache::flush()
+{
+    if (!diskCache.exists())
+        return;
+    QGtkDiskCacheData *d = diskCache();
+    if (d->valid && !d->pending.isEmpty()) {
+        QList<QGtkDiskCacheEntry> entries;
+        entries.reserve(d->index.size() + d->pending.size());
+        for (const QGtkDiskCacheEntry *entry : std::as_const(d->index))
+            entries.append(*entry);
+        for (auto it = d->pending.constBegin(); it != d->pending.constEnd(); ++it) {
+            QGtkDiskCacheEntry entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.key = it.key();
+            entry.width = it->width();
+            entry.height = it->height();
+            entry.format = it->format();
+            entries.append(entry);
+        }
+
+        QGtkDiskCacheHeader header;
+        memcpy(header.magic, qt_gtk_cache_magic, sizeof(header.magic));
+        header.version = qt_gtk_cache_version;
+        header.count = entries.size();
+        header.stamp = d->stamp;
+
+        // Pixels start after the index, aligned for the mapping
+        quint64 offset = (sizeof(header) + entries.size() * sizeof(QGtkDiskCacheEntry) + 15) & ~quint64(15);
+        for (QGtkDiskCacheEntry &entry : entries) {
+            entry.offset = offset;
+            offset += (quint64(entry.width) * entry.height * 4 + 15) & ~quint64(15);
+        }
+
+        QSaveFile out(d->fileName);
+        if (out.open(QIODevice::WriteOnly)) {
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char *>(entries.constData()), entries.size() * sizeof(QGtkDiskCacheEntry));
+            for (const QGtkDiskCacheEntry &entry : std::as_const(entries)) {
+                out.seek(entry.offset);
+                const qint64 bytes = qint64(entry.width) * entry.height * 4;
+                if (const QGtkDiskCacheEntry *mapped = d->index.value(entry.key)) {
+                    out.write(reinterpret_cast<const char *>(d->data + mapped->offset), bytes);
+                } else {
+                    const QImage image = d->pending.value(entry.key);
+                    for (int y = 0; y < image.height(); ++y)
+                        out.write(reinterpret_cast<const char *>(image.constScanLine(y)), image.width() * 4);
+                }
+            }
+            out.commit();
+        }
+    }
+
+    // Start over on next use, the theme may have changed
+    d->close();
+    d->pending.clear();
+    d->pendingSize = 0;
+    d->opened = false;
+    d->valid = false;
+    d->stamped = false;
+}
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
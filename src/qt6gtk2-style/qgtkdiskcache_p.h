@@ -0,0 +1,64 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef QGTKDISKCACHE_P_H
+#define QGTKDISKCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGlobal>
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QPixmap>
+#include "qgtkpainter_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Keeps rendered elements across processes in
+// $XDG_CACHE_HOME/qt6gtk2/<theme>.cache, one file per theme. The file is
+// memory mapped on first use and rewritten with the new renders when the
+// application quits or the theme changes. It is ignored and rebuilt when
+// the theme, any file of its gtk-2.0 directory, its engine module, the
+// gtkrc files, the color scheme or the font changed since it was written.
+// QT6GTK2_DISK_CACHE=0 disables it.
+class QGtkDiskCache
+{
+public:
+    static bool find(const QGtkPainterKey &key, QPixmap *pixmap);
+    static void insert(const QGtkPainterKey &key, const QPixmap &pixmap);
+    // Identifies the theme state the renders depend on, see above
+    static quint64 themeStamp();
+    // Writes the new renders out and forgets the current theme
+    static void flush();
+};
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
+
+#endif // QGTKDISKCACHE_P_H
@@ -19,14 +19,19 @@
  ***************************************************************************/
 
 #include "qgtkpainter_p.h"
+#include "qgtkstats_p.h"
 
 #if !defined(QT_NO_STYLE_GTK)
 
-#include <private/qhexstring_p.h>
+#include <QHash>
+#include <QList>
+#include <QByteArray>
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE
 
-QGtkPainter::QGtkPainter()
+QGtkPainter::QGtkPainter() :
+    m_defaultWidget(nullptr)
 {
     reset(nullptr);
 }
@@ -38,24 +43,200 @@ QGtkPainter::~QGtkPainter()
 void QGtkPainter::reset(QPainter *painter)
 {
     m_painter = painter;
+    m_dpr = painter && painter->device() ? painter->device()->devicePixelRatio() : 1.0;
     m_alpha = true;
     m_hflipped = false;
     m_vflipped = false;
     m_usePixmapCache = true;
     m_cliprect = QRect();
+
+    // Proto widget state belongs to the control being drawn. What was not
+    // applied yet is dropped, the widgets keep what GTK+ has.
+    m_focusWidgets.clear();
+    m_defaultWidget = nullptr;
+    m_widgetDirections.erase(std::remove_if(m_widgetDirections.begin(), m_widgetDirections.end(),
+                                            [](const WidgetDirection &d) { return d.dirty; }),
+                             m_widgetDirections.end());
+    m_rangeAdjustments.erase(std::remove_if(m_rangeAdjustments.begin(), m_rangeAdjustments.end(),
+                                            [](const RangeAdjustment &a) { return a.dirty || a.invertedDirty; }),
+                             m_rangeAdjustments.end());
 }
 
-QString QGtkPainter::uniqueName(const QString &key, GtkStateType state, GtkShadowType shadow,
-                                const QSize &size, GtkWidget *widget)
+QGtkPainterKey QGtkPainter::cacheKey(Element element, const gchar *part, GtkStateType state, GtkShadowType shadow,
+                                     const QSize &size, GtkWidget *widget, const QGtkPainterExtra &extra) const
 {
+    // Every paint function makes its key first. Options and checkboxes
+    // have no part, they pass their detail instead.
+    if (QGtkStats::isEnabled())
+        QGtkStats::paint(element, part);
+
     // Note the widget arg should ideally use the widget path, though would compromise performance
-    QString tmp = key
-                  % HexString<uint>(state)
-                  % HexString<uint>(shadow)
-                  % HexString<uint>(size.width())
-                  % HexString<uint>(size.height())
-                  % HexString<quint64>(quint64(widget));
-    return tmp;
+    QGtkPainterKey key;
+    memset(&key, 0, sizeof(key));
+    key.element = element;
+    key.state = state;
+    key.shadow = shadow;
+    key.flags = (m_alpha ? 0x1 : 0) | (m_hflipped ? 0x2 : 0) | (m_vflipped ? 0x4 : 0) |
+            (m_focusWidgets.isEmpty() ? 0 : 0x8) | (m_defaultWidget ? 0x10 : 0);
+    for (const WidgetDirection &direction : m_widgetDirections) {
+        if (direction.widget == widget && direction.direction == GTK_TEXT_DIR_RTL)
+            key.flags |= 0x20;
+    }
+    key.width = size.width();
+    key.height = size.height();
+    key.part = part;
+    key.widget = widget;
+    key.dpr = qRound(m_dpr * 100);
+    key.extra = extra;
+    return key;
+}
+
+void QGtkPainter::setWidgetFocus(GtkWidget *widget, bool focus)
+{
+    if (!focus) {
+        m_focusWidgets.removeAll(widget);
+        return;
+    }
+    if (!m_focusWidgets.contains(widget))
+        m_focusWidgets.append(widget);
+}
+
+void QGtkPainter::setWidgetDirection(GtkWidget *widget, GtkTextDirection direction)
+{
+    if (!widget)
+        return;
+    for (WidgetDirection &d : m_widgetDirections) {
+        if (d.widget != widget)
+            continue;
+        if (d.direction != direction) {
+            d.direction = direction;
+            d.dirty = true;
+        }
+        return;
+    }
+    m_widgetDirections.append({ widget, direction, true });
+}
+
+void QGtkPainter::setRangeAdjustment(GtkRange *range, gdouble value, gdouble lower, gdouble upper,
+                                     gdouble stepIncrement, gdouble pageIncrement, gdouble pageSize)
+{
+    const gdouble values[6] = { value, lower, upper, stepIncrement, pageIncrement, pageSize };
+    for (RangeAdjustment &a : m_rangeAdjustments) {
+        if (a.range != range)
+            continue;
+        if (memcmp(a.values, values, sizeof(values))) {
+            memcpy(a.values, values, sizeof(values));
+            a.dirty = true;
+        }
+        return;
+    }
+    RangeAdjustment adjustment;
+    adjustment.range = range;
+    memcpy(adjustment.values, values, sizeof(values));
+    adjustment.dirty = true;
+    adjustment.inverted = -1;
+    adjustment.invertedDirty = false;
+    m_rangeAdjustments.append(adjustment);
+}
+
+void QGtkPainter::setRangeInverted(GtkRange *range, bool inverted)
+{
+    for (RangeAdjustment &a : m_rangeAdjustments) {
+        if (a.range != range)
+            continue;
+        if (a.inverted != qint8(inverted)) {
+            a.inverted = inverted;
+            a.invertedDirty = true;
+        }
+        return;
+    }
+    RangeAdjustment adjustment;
+    memset(&adjustment, 0, sizeof(adjustment));
+    adjustment.range = range;
+    adjustment.inverted = inverted;
+    adjustment.invertedDirty = true;
+    m_rangeAdjustments.append(adjustment);
+}
+
+namespace {
+
+struct QGtkStableKeyData
+{
+    QHash<const gchar *, quint64> partHashes;
+    QHash<GtkWidget *, quint64> widgetHashes;
+    QList<QByteArray> detailTexts;   // by id - 1
+    QList<quint64> detailHashes;
+};
+
+}
+
+Q_GLOBAL_STATIC(QGtkStableKeyData, stableKeyData)
+
+QGtkStableKey QGtkPainter::stableKey(const QGtkPainterKey &key)
+{
+    QGtkStableKey stable;
+    memset(&stable, 0, sizeof(stable));
+    stable.element = key.element;
+    stable.state = key.state;
+    stable.shadow = key.shadow;
+    stable.flags = key.flags;
+    stable.width = key.width;
+    stable.height = key.height;
+    memcpy(stable.params, key.params, sizeof(stable.params));
+    stable.dpr = key.dpr;
+    stable.extra = key.extra;
+    stable.extra.detail = 0;
+
+    QGtkStableKeyData *d = stableKeyData();
+    if (key.extra.detail)
+        stable.detail = d->detailHashes.at((key.extra.detail & ~QGtkPainterExtra::LocalDetail) - 1);
+    if (key.part) {
+        auto it = d->partHashes.constFind(key.part);
+        if (it == d->partHashes.constEnd())
+            it = d->partHashes.insert(key.part, qt_gtk_stable_hash(key.part, strlen(key.part)));
+        stable.part = *it;
+    }
+    if (key.widget) {
+        auto it = d->widgetHashes.constFind(key.widget);
+        if (it == d->widgetHashes.constEnd()) {
+            gchar *path = nullptr;
+            gtk_widget_path(key.widget, nullptr, &path, nullptr);
+            it = d->widgetHashes.insert(key.widget, path ? qt_gtk_stable_hash(path, strlen(path)) : 0);
+            g_free(path);
+        }
+        stable.widget = *it;
+    }
+    return stable;
+}
+
+quint32 QGtkPainter::detailId(const char *text)
+{
+    // The details are a handful of literals, so the table stays small and
+    // outlives theme changes. Two details with the same 64 bit FNV-1a
+    // value are only told apart in this process: other processes may
+    // register them in another order, so the later one stays out of the
+    // shared and disk caches.
+    QGtkStableKeyData *d = stableKeyData();
+    const QByteArray detail(text);
+    const int index = d->detailTexts.indexOf(detail);
+    if (index >= 0) {
+        const quint32 id = index + 1;
+        return d->detailHashes.indexOf(d->detailHashes.at(index)) < index ? id | QGtkPainterExtra::LocalDetail : id;
+    }
+    const quint64 hash = qt_gtk_stable_hash(detail.constData(), detail.size());
+    const bool local = d->detailHashes.contains(hash);
+    d->detailTexts.append(detail);
+    d->detailHashes.append(hash);
+    const quint32 id = d->detailTexts.size();
+    return local ? id | QGtkPainterExtra::LocalDetail : id;
+}
+
+void QGtkPainter::clearStableKeys()
+{
+    if (!stableKeyData.exists())
+        return;
+    stableKeyData()->partHashes.clear();
+    stableKeyData()->widgetHashes.clear();
 }
 
 QT_END_NAMESPACE
@@ -41,9 +41,124 @@
 #include <QPoint>
 #include <QPixmap>
 #include <QPainter>
+#include <QHashFunctions>
+#include <QVarLengthArray>
+#include <cstring>
 
 QT_BEGIN_NAMESPACE
 
+// What a rendering depends on besides the arguments of the GTK+ call,
+// like the focus of the control or a fake slider position. Callers pass
+// it along with the paint function, so building one allocates nothing.
+struct QGtkPainterExtra
+{
+    enum Flag
+    {
+        Focus = 0x1,
+        Default = 0x2,
+        RightToLeft = 0x4,
+        Editable = 0x8,
+        Inverted = 0x10,
+        Active = 0x20
+    };
+
+    // Set on details whose stable hash collides with another one's
+    static constexpr quint32 LocalDetail = 0x80000000;
+
+    // Trivial, so that the keys stay plain data; QGtkPainterExtra() is all zero
+    QGtkPainterExtra() = default;
+    constexpr QGtkPainterExtra(quint32 flags, qint32 value = 0, qint32 value2 = 0, quint32 detail = 0) :
+        detail(detail), flags(flags), values{ value, value2 } {}
+
+    quint32 detail;    // see QGtkPainter::detailId(), 0 for none
+    quint32 flags;
+    qint32 values[2];  // positions, widget ids or states
+};
+
+static_assert(sizeof(QGtkPainterExtra) == 2 * sizeof(quint32) + 2 * sizeof(qint32),
+              "QGtkPainterExtra must not have padding");
+
+// Identifies a cached rendering of a GtkStyle painting function. It is
+// plain data, so looking up a pixmap allocates nothing.
+struct QGtkPainterKey
+{
+    quint8 element;
+    quint8 state;
+    quint8 shadow;
+    quint8 flags;
+    qint32 width;
+    qint32 height;
+    qint32 params[4];
+    qint32 dpr;        // device pixel ratio in percent
+    const gchar *part; // compared by address, parts are string literals
+    GtkWidget *widget;
+    QGtkPainterExtra extra;
+};
+
+// No padding, so the key can be compared and hashed as a whole
+static_assert(sizeof(QGtkPainterKey) == 4 * sizeof(quint8) + 7 * sizeof(qint32) + 2 * sizeof(void *) + sizeof(QGtkPainterExtra),
+              "QGtkPainterKey must not have padding");
+
+inline bool operator==(const QGtkPainterKey &a, const QGtkPainterKey &b)
+{
+    return !memcmp(&a, &b, sizeof(QGtkPainterKey));
+}
+
+inline size_t qHash(const QGtkPainterKey &key, size_t seed = 0)
+{
+    return qHashBits(&key, sizeof(QGtkPainterKey), seed);
+}
+
+// Keys with a detail whose stable hash was moved off a collision; they
+// only mean something in this process
+inline bool qt_gtk_is_shareable(const QGtkPainterKey &key)
+{
+    return !(key.extra.detail & QGtkPainterExtra::LocalDetail);
+}
+
+// 64 bit FNV-1a, unlike qHash() it gives the same value in every process
+inline quint64 qt_gtk_stable_hash(const void *data, size_t size, quint64 hash = Q_UINT64_C(14695981039346656037))
+{
+    const uchar *bytes = static_cast<const uchar *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= Q_UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+// A QGtkPainterKey with the addresses and the detail id replaced by
+// hashes of what they stand for, so that it means the same in every
+// process
+struct QGtkStableKey
+{
+    quint8 element;
+    quint8 state;
+    quint8 shadow;
+    quint8 flags;
+    qint32 width;
+    qint32 height;
+    qint32 params[4];
+    qint32 dpr;
+    quint64 part;
+    quint64 widget;
+    quint64 detail;
+    QGtkPainterExtra extra; // with detail cleared
+};
+
+static_assert(sizeof(QGtkStableKey) == 4 * sizeof(quint8) + 7 * sizeof(qint32) + 3 * sizeof(quint64) + sizeof(QGtkPainterExtra),
+              "QGtkStableKey must not have padding");
+
+inline bool operator==(const QGtkStableKey &a, const QGtkStableKey &b)
+{
+    return !memcmp(&a, &b, sizeof(QGtkStableKey));
+}
+
+inline size_t qHash(const QGtkStableKey &key, size_t seed = 0)
+{
+    return qHashBits(&key, sizeof(QGtkStableKey), seed);
+}
+
 class QGtkPainter
 {
 public:
@@ -58,45 +173,116 @@ public:
     void setFlipVertical(bool value) { m_vflipped = value; }
     void setUsePixmapCache(bool value) { m_usePixmapCache = value; }
 
+    // State of the proto widgets that the following elements depend on.
+    // It is only applied to the widgets when an element has to be
+    // rendered, cache hits leave GTK+ alone.
+    void setWidgetFocus(GtkWidget *widget, bool focus);
+    void setWidgetDirection(GtkWidget *widget, GtkTextDirection direction);
+    void setDefaultWidget(GtkWidget *widget) { m_defaultWidget = widget; }
+    void setRangeAdjustment(GtkRange *range, gdouble value, gdouble lower, gdouble upper,
+                            gdouble stepIncrement, gdouble pageIncrement, gdouble pageSize);
+    void setRangeInverted(GtkRange *range, bool inverted);
+
     virtual void paintBoxGap(GtkWidget *gtkWidget, const gchar* part, const QRect &rect,
                              GtkStateType state, GtkShadowType shadow, GtkPositionType gap_side, gint x,
                              gint width, GtkStyle *style) = 0;
     virtual void paintBox(GtkWidget *gtkWidget, const gchar* part,
                           const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style,
-                          const QString &pmKey = QString()) = 0;
+                          const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
     virtual void paintHline(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkStyle *style,
-                            int x1, int x2, int y, const QString &pmKey = QString()) = 0;
+                            int x1, int x2, int y, const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
     virtual void paintVline(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkStyle *style,
-                            int y1, int y2, int x, const QString &pmKey = QString()) = 0;
+                            int y1, int y2, int x, const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
     virtual void paintExpander(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state,
-                               GtkExpanderStyle expander_state, GtkStyle *style, const QString &pmKey = QString()) = 0;
+                               GtkExpanderStyle expander_state, GtkStyle *style, const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
     virtual void paintFocus(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkStyle *style,
-                            const QString &pmKey = QString()) = 0;
+                            const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
     virtual void paintResizeGrip(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow,
-                                 GdkWindowEdge edge, GtkStyle *style, const QString &pmKey = QString()) = 0;
+                                 GdkWindowEdge edge, GtkStyle *style, const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
     virtual void paintArrow(GtkWidget *gtkWidget, const gchar* part, const QRect &arrowrect, GtkArrowType arrow_type, GtkStateType state, GtkShadowType shadow,
-                            gboolean fill, GtkStyle *style, const QString &pmKey = QString()) = 0;
+                            gboolean fill, GtkStyle *style, const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
     virtual void paintHandle(GtkWidget *gtkWidget, const gchar* part, const QRect &rect,
                              GtkStateType state, GtkShadowType shadow, GtkOrientation orientation, GtkStyle *style) = 0;
     virtual void paintSlider(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow,
-                             GtkStyle *style, GtkOrientation orientation, const QString &pmKey = QString()) = 0;
+                             GtkStyle *style, GtkOrientation orientation, const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
     virtual void paintShadow(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow,
-                             GtkStyle *style, const QString &pmKey = QString()) = 0;
-    virtual void paintFlatBox(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const QString & = QString()) = 0;
+                             GtkStyle *style, const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
+    virtual void paintFlatBox(GtkWidget *gtkWidget, const gchar* part, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style,
+                              const QGtkPainterExtra &extra = QGtkPainterExtra()) = 0;
     virtual void paintExtention(GtkWidget *gtkWidget, const gchar *part, const QRect &rect, GtkStateType state, GtkShadowType shadow,
                                 GtkPositionType gap_pos, GtkStyle *style) = 0;
-    virtual void paintOption(GtkWidget *gtkWidget, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const QString &detail) = 0;
-    virtual void paintCheckbox(GtkWidget *gtkWidget, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const QString &detail) = 0;
+    virtual void paintOption(GtkWidget *gtkWidget, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const gchar *detail) = 0;
+    virtual void paintCheckbox(GtkWidget *gtkWidget, const QRect &rect, GtkStateType state, GtkShadowType shadow, GtkStyle *style, const gchar *detail) = 0;
+
+    // Drops what the painter learned about the current theme
+    virtual void clearCaches() {}
+
+    // Keys of the caches shared with other processes; the widget hashes
+    // are remembered until the widgets go away with the theme
+    static QGtkStableKey stableKey(const QGtkPainterKey &key);
+    static void clearStableKeys();
+
+    // Id of a detail that tells renders apart which are otherwise the
+    // same, for QGtkPainterExtra. Callers keep it in a static, the text
+    // is only hashed the first time.
+    static quint32 detailId(const char *text);
 
 protected:
-    static QString uniqueName(const QString &key, GtkStateType state, GtkShadowType shadow, const QSize &size, GtkWidget *widget = nullptr);
+    enum Element
+    {
+        Box,
+        BoxGap,
+        Hline,
+        Vline,
+        Expander,
+        Focus,
+        ResizeGrip,
+        Arrow,
+        Handle,
+        Slider,
+        Shadow,
+        FlatBox,
+        Extension,
+        Option,
+        Checkbox
+    };
+
+    QGtkPainterKey cacheKey(Element element, const gchar *part, GtkStateType state, GtkShadowType shadow,
+                            const QSize &size, GtkWidget *widget = nullptr, const QGtkPainterExtra &extra = QGtkPainterExtra()) const;
+
+    int devicePixels(int value) const { return qRound(value * m_dpr); }
+    QSize deviceSize(const QSize &size) const { return size * m_dpr; }
 
     QPainter *m_painter;
+    qreal m_dpr;
     bool m_alpha;
     bool m_hflipped;
     bool m_vflipped;
     bool m_usePixmapCache;
     QRect m_cliprect;
+
+    // Directions and adjustments stay with the widgets, like GTK+ keeps
+    // them, and are only set again when they change
+    struct WidgetDirection
+    {
+        GtkWidget *widget;
+        GtkTextDirection direction;
+        bool dirty;
+    };
+
+    struct RangeAdjustment
+    {
+        GtkRange *range;
+        gdouble values[6];
+        bool dirty;
+        qint8 inverted; // -1 until set
+        bool invertedDirty;
+    };
+
+    QVarLengthArray<GtkWidget *, 4> m_focusWidgets;
+    GtkWidget *m_defaultWidget;
+    QVarLengthArray<WidgetDirection, 8> m_widgetDirections;
+    QVarLengthArray<RangeAdjustment, 4> m_rangeAdjustments;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,277 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "qgtkpixmapcache_p.h"
+
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include "qgtkdiskcache_p.h"
+#include "qgtksharedcache_p.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Element of the keys made from strings, their hash lives in key.extra.values
+enum { NamedElement = 0xff };
+
+struct QGtkPixmapCacheEntry
+{
+    QPixmap pixmap;
+    QString name; // tells colliding string keys apart
+};
+
+// Where an element lives in the atlas
+struct QGtkAtlasTile
+{
+    int page;
+    QRect rect;
+};
+
+// Elements are packed in rows of similar height; a gap between them keeps
+// filtering from picking up the neighbours
+enum
+{
+    AtlasPageSize = 512,
+    AtlasMaxPages = 4,
+    AtlasMaxTile = 64,
+    AtlasGap = 1
+};
+
+struct QGtkAtlasPage
+{
+    QPixmap pixmap;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    int x = 0;
+};
+
+struct QGtkAtlas
+{
+    bool allocate(const QSize &size, QGtkAtlasTile *tile);
+    void clear()
+    {
+        pages.clear();
+        tiles.clear();
+    }
+
+    QList<QGtkAtlasPage> pages;
+    QHash<QGtkPainterKey, QGtkAtlasTile> tiles;
+};
+
+bool QGtkAtlas::allocate(const QSize &size, QGtkAtlasTile *tile)
+{
+    const int width = size.width() + AtlasGap;
+    const int height = size.height() + AtlasGap;
+    if (width > AtlasPageSize || height > AtlasPageSize)
+        return false;
+
+    for (int i = 0; i < pages.size(); ++i) {
+        QGtkAtlasPage &page = pages[i];
+        if (page.x + width > AtlasPageSize || height > page.shelfHeight) {
+            // Open a new shelf below the current one
+            if (page.shelfY + page.shelfHeight + height > AtlasPageSize)
+                continue;
+            page.shelfY += page.shelfHeight;
+            page.shelfHeight = height;
+            page.x = 0;
+        }
+        *tile = { i, QRect(QPoint(page.x, page.shelfY), size) };
+        page.x += width;
+        return true;
+    }
+
+    // Start over when full, the elements in use come back quickly
+    if (pages.size() == AtlasMaxPages)
+        clear();
+    QGtkAtlasPage page;
+    page.pixmap = QPixmap(AtlasPageSize, AtlasPageSize);
+    page.pixmap.fill(Qt::transparent);
+    page.shelfHeight = height;
+    page.x = width;
+    pages.append(page);
+    *tile = { int(pages.size() - 1), QRect(QPoint(0, 0), size) };
+    return true;
+}
+
+struct QGtkPixmapCacheData
+{
+    QGtkPixmapCacheData()
+    {
+        // The limit is in kilobytes, like QPixmapCache::cacheLimit()
+        bool ok = false;
+        const int limit = qEnvironmentVariableIntValue("QT6GTK2_CACHE_LIMIT", &ok);
+        cache.setMaxCost(ok && limit > 0 ? limit : 10240);
+    }
+
+    QCache<QGtkPainterKey, QGtkPixmapCacheEntry> cache;
+    QGtkAtlas atlas;
+};
+
+}
+
+Q_GLOBAL_STATIC(QGtkPixmapCacheData, pixmapCache)
+
+static QGtkPainterKey qt_gtk_named_key(const QString &name)
+{
+    QGtkPainterKey key;
+    memset(&key, 0, sizeof(key));
+    key.element = NamedElement;
+    const quint64 hash = qHash(name);
+    key.extra.values[0] = qint32(hash);
+    key.extra.values[1] = qint32(hash >> 32);
+    return key;
+}
+
+static int qt_gtk_pixmap_cost(const QPixmap &pixmap)
+{
+    const qsizetype bytes = qsizetype(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    return qMax<int>(1, int(bytes / 1024));
+}
+
+bool QGtkPixmapCache::find(const QGtkPainterKey &key, QPixmap *pixmap)
+{
+    if (const QGtkPixmapCacheEntry *entry = pixmapCache()->cache.object(key)) {
+        *pixmap = entry->pixmap;
+        return true;
+    }
+    if (!qt_gtk_is_shareable(key))
+        return false;
+    // Rendered by another running process
+    if (QGtkSharedCache::find(key, pixmap)) {
+        pixmapCache()->cache.insert(key, new QGtkPixmapCacheEntry{*pixmap, QString()}, qt_gtk_pixmap_cost(*pixmap));
+        return true;
+    }
+    // Rendered by an earlier process
+    if (QGtkDiskCache::find(key, pixmap)) {
+        pixmapCache()->cache.insert(key, new QGtkPixmapCacheEntry{*pixmap, QString()}, qt_gtk_pixmap_cost(*pixmap));
+        QGtkSharedCache::insert(key, *pixmap);
+        return true;
+    }
+    return false;
+}
+
+void QGtkPixmapCache::insert(const QGtkPainterKey &key, const QPixmap &pixmap)
+{
+    pixmapCache()->cache.insert(key, new QGtkPixmapCacheEntry{pixmap, QString()}, qt_gtk_pixmap_cost(pixmap));
+    if (!qt_gtk_is_shareable(key))
+        return;
+    QGtkSharedCache::insert(key, pixmap);
+    QGtkDiskCache::insert(key, pixmap);
+}
+
+static bool qt_gtk_is_tile(const QPixmap &pixmap)
+{
+    return pixmap.width() <= AtlasMaxTile && pixmap.height() <= AtlasMaxTile;
+}
+
+static bool qt_gtk_pack_tile(const QGtkPainterKey &key, const QPixmap &pixmap, QPixmap *page, QRect *source)
+{
+    QGtkAtlas &atlas = pixmapCache()->atlas;
+    QGtkAtlasTile tile;
+    if (!qt_gtk_is_tile(pixmap) || !atlas.allocate(pixmap.size(), &tile))
+        return false;
+
+    QPainter painter(&atlas.pages[tile.page].pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawPixmap(tile.rect, pixmap, pixmap.rect());
+    painter.end();
+    atlas.tiles.insert(key, tile);
+    if (page) {
+        *page = atlas.pages.at(tile.page).pixmap;
+        *source = tile.rect;
+    }
+    return true;
+}
+
+bool QGtkPixmapCache::findTile(const QGtkPainterKey &key, QPixmap *page, QRect *source)
+{
+    const QGtkAtlas &atlas = pixmapCache()->atlas;
+    auto it = atlas.tiles.constFind(key);
+    if (it != atlas.tiles.constEnd()) {
+        *page = atlas.pages.at(it->page).pixmap;
+        *source = it->rect;
+        return true;
+    }
+
+    // Large elements, and small ones rendered by other processes
+    if (!find(key, page))
+        return false;
+    if (qt_gtk_is_tile(*page)) {
+        pixmapCache()->cache.remove(key);
+        const QPixmap pixmap = *page;
+        if (qt_gtk_pack_tile(key, pixmap, page, source))
+            return true;
+    }
+    *source = page->rect();
+    return true;
+}
+
+void QGtkPixmapCache::insertTile(const QGtkPainterKey &key, const QPixmap &pixmap)
+{
+    if (!qt_gtk_pack_tile(key, pixmap, nullptr, nullptr)) {
+        insert(key, pixmap);
+        return;
+    }
+    if (!qt_gtk_is_shareable(key))
+        return;
+    QGtkSharedCache::insert(key, pixmap);
+    QGtkDiskCache::insert(key, pixmap);
+}
+
+bool QGtkPixmapCache::find(const QString &key, QPixmap *pixmap)
+{
+    const QGtkPixmapCacheEntry *entry = pixmapCache()->cache.object(qt_gtk_named_key(key));
+    if (!entry || entry->name != key)
+        return false;
+    *pixmap = entry->pixmap;
+    return true;
+}
+
+void QGtkPixmapCache::insert(const QString &key, const QPixmap &pixmap)
+{
+    pixmapCache()->cache.insert(qt_gtk_named_key(key), new QGtkPixmapCacheEntry{pixmap, key},
+                                qt_gtk_pixmap_cost(pixmap));
+}
+
+int QGtkPixmapCache::cacheLimit()
+{
+    return int(pixmapCache()->cache.maxCost());
+}
+
+void QGtkPixmapCache::setCacheLimit(int kilobytes)
+{
+    pixmapCache()->cache.setMaxCost(kilobytes);
+}
+
+void QGtkPixmapCache::clear()
+{
+    pixmapCache()->cache.clear();
+    pixmapCache()->atlas.clear();
+    QGtkDiskCache::flush();
+    QGtkSharedCache::detach();
+    QGtkPainter::clearStableKeys();
+}
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
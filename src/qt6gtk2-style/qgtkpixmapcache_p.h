@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef QGTKPIXMAPCACHE_P_H
+#define QGTKPIXMAPCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGlobal>
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QString>
+#include <QPixmap>
+#include <QImage>
+#include <QPainter>
+#include "qgtkpainter_p.h"
+#include "qstylehelper_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Pixmap cache of the style, used instead of QPixmapCache so that theme
+// elements and application pixmaps neither evict nor invalidate each
+// other. Entries are dropped least recently used first once the limit
+// is reached.
+//
+// Small elements such as arrows, indicators and expanders are packed into
+// a few atlas pages instead, found with findTile() as a page and the rect
+// of the element in it. The atlas starts over once its pages are full.
+class QGtkPixmapCache
+{
+public:
+    static bool find(const QGtkPainterKey &key, QPixmap *pixmap);
+    static void insert(const QGtkPainterKey &key, const QPixmap &pixmap);
+    static bool findTile(const QGtkPainterKey &key, QPixmap *page, QRect *source);
+    static void insertTile(const QGtkPainterKey &key, const QPixmap &pixmap);
+    static bool find(const QString &key, QPixmap *pixmap);
+    static void insert(const QString &key, const QPixmap &pixmap);
+    static int cacheLimit();
+    static void setCacheLimit(int kilobytes);
+    static void clear();
+};
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
+#define QGTK_STYLE_CACHE_DPR painter->device()->devicePixelRatio()
+#define QGTK_STYLE_CACHE_NAME(a) QStyleHelper::uniqueName((a), option, option->rect.size(), dpr)
+#else
+#define QGTK_STYLE_CACHE_DPR 1.0
+#define QGTK_STYLE_CACHE_NAME(a) QStyleHelper::uniqueName((a), option, option->rect.size())
+#endif
+
+// Same as BEGIN_STYLE_PIXMAPCACHE and END_STYLE_PIXMAPCACHE from
+// qstyle_p.h, but caching in QGtkPixmapCache
+#define BEGIN_GTK_STYLE_PIXMAPCACHE(a) \
+    QRect rect = option->rect; \
+    QPixmap internalPixmapCache; \
+    QImage imageCache; \
+    QPainter *p = painter; \
+    const qreal dpr = QGTK_STYLE_CACHE_DPR; \
+    const QString unique = QGTK_STYLE_CACHE_NAME(a); \
+    int txType = painter->deviceTransform().type() | painter->worldTransform().type(); \
+    bool doPixmapCache = (!option->rect.isEmpty()) \
+            && ((txType <= QTransform::TxTranslate) || (painter->deviceTransform().type() == QTransform::TxScale)); \
+    if (doPixmapCache && QGtkPixmapCache::find(unique, &internalPixmapCache)) { \
+        painter->drawPixmap(option->rect.topLeft(), internalPixmapCache); \
+    } else { \
+        if (doPixmapCache) { \
+            rect.setRect(0, 0, option->rect.width(), option->rect.height()); \
+            imageCache = QImage(option->rect.size() * dpr, QImage::Format_ARGB32_Premultiplied); \
+            imageCache.setDevicePixelRatio(dpr); \
+            imageCache.fill(0); \
+            p = new QPainter(&imageCache); \
+        }
+
+#define END_GTK_STYLE_PIXMAPCACHE \
+        if (doPixmapCache) { \
+            p->end(); \
+            delete p; \
+            internalPixmapCache = QPixmap::fromImage(std::move(imageCache)); \
+            painter->drawPixmap(option->rect.topLeft(), internalPixmapCache); \
+            QGtkPixmapCache::insert(unique, internalPixmapCache); \
+        } \
+    }
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
+
+#endif // QGTKPIXMAPCACHE_P_H
@@ -0,0 +1,154 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "qgtkrendertheme_p.h"
+
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <private/qsimd_p.h>
+
+QT_BEGIN_NAMESPACE
+
+void qt_gtk_render_theme_generic(uchar *bdata, const uchar *wdata, int pixelCount)
+{
+    const int bytecount = pixelCount * 4;
+    for (int index = 0; index < bytecount ; index += 4) {
+        uchar val = bdata[index + GTK_BLUE];
+        if (wdata) {
+            int alphaval = qMax(bdata[index + GTK_BLUE] - wdata[index + GTK_BLUE],
+                                bdata[index + GTK_GREEN] - wdata[index + GTK_GREEN]);
+            alphaval = qMax(alphaval, bdata[index + GTK_RED] - wdata[index + GTK_RED]) + 255;
+            bdata[index + QT_ALPHA] = alphaval;
+        }
+        bdata[index + QT_RED] = bdata[index + GTK_RED];
+        bdata[index + QT_GREEN] = bdata[index + GTK_GREEN];
+        bdata[index + QT_BLUE] = val;
+    }
+}
+
+#if defined(__SSE2__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+// Same as the generic version for 4 pixels at a time. The channel
+// differences are computed in 16 bit lanes and truncated to 8 bits
+// afterwards, so the result is bit-identical to the scalar loop.
+static void qt_gtk_render_theme_sse2(uchar *bdata, const uchar *wdata, int pixelCount)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i byteMask = _mm_set1_epi32(0x000000ff);
+    const __m128i greenAlphaMask = _mm_set1_epi32(int(0xff00ff00));
+    const __m128i alphaMask = _mm_set1_epi32(int(0xff000000));
+    const __m128i offset = _mm_set1_epi16(255);
+    const __m128i lowByte = _mm_set1_epi16(0x00ff);
+
+    int i = 0;
+    for (; i + 4 <= pixelCount; i += 4) {
+        __m128i *dst = reinterpret_cast<__m128i *>(bdata + i * 4);
+        const __m128i black = _mm_loadu_si128(dst);
+        __m128i result = _mm_or_si128(_mm_and_si128(black, greenAlphaMask),
+                                      _mm_or_si128(_mm_and_si128(_mm_srli_epi32(black, 16), byteMask),
+                                                   _mm_slli_epi32(_mm_and_si128(black, byteMask), 16)));
+        if (wdata) {
+            const __m128i white = _mm_loadu_si128(reinterpret_cast<const __m128i *>(wdata + i * 4));
+            __m128i alpha[2];
+            for (int half = 0; half < 2; ++half) {
+                const __m128i diff = half ? _mm_sub_epi16(_mm_unpackhi_epi8(black, zero), _mm_unpackhi_epi8(white, zero))
+                                          : _mm_sub_epi16(_mm_unpacklo_epi8(black, zero), _mm_unpacklo_epi8(white, zero));
+                __m128i max = _mm_max_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(diff, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0)),
+                                            _mm_shufflehi_epi16(_mm_shufflelo_epi16(diff, _MM_SHUFFLE(1, 1, 1, 1)), _MM_SHUFFLE(1, 1, 1, 1)));
+                max = _mm_max_epi16(max, _mm_shufflehi_epi16(_mm_shufflelo_epi16(diff, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 2, 2, 2)));
+                alpha[half] = _mm_and_si128(_mm_add_epi16(max, offset), lowByte);
+            }
+            result = _mm_or_si128(_mm_andnot_si128(alphaMask, result),
+                                  _mm_and_si128(alphaMask, _mm_packus_epi16(alpha[0], alpha[1])));
+        }
+        _mm_storeu_si128(dst, result);
+    }
+    qt_gtk_render_theme_generic(bdata + i * 4, wdata ? wdata + i * 4 : nullptr, pixelCount - i);
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+// AVX2 variant of the SSE2 kernel, 8 pixels at a time. Unpacking and
+// packing work per 128 bit lane, so the pixel order is preserved.
+QT_FUNCTION_TARGET(AVX2)
+static void qt_gtk_render_theme_avx2(uchar *bdata, const uchar *wdata, int pixelCount)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i byteMask = _mm256_set1_epi32(0x000000ff);
+    const __m256i greenAlphaMask = _mm256_set1_epi32(int(0xff00ff00));
+    const __m256i alphaMask = _mm256_set1_epi32(int(0xff000000));
+    const __m256i offset = _mm256_set1_epi16(255);
+    const __m256i lowByte = _mm256_set1_epi16(0x00ff);
+
+    int i = 0;
+    for (; i + 8 <= pixelCount; i += 8) {
+        __m256i *dst = reinterpret_cast<__m256i *>(bdata + i * 4);
+        const __m256i black = _mm256_loadu_si256(dst);
+        __m256i result = _mm256_or_si256(_mm256_and_si256(black, greenAlphaMask),
+                                         _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(black, 16), byteMask),
+                                                         _mm256_slli_epi32(_mm256_and_si256(black, byteMask), 16)));
+        if (wdata) {
+            const __m256i white = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(wdata + i * 4));
+            const __m256i diffLo = _mm256_sub_epi16(_mm256_unpacklo_epi8(black, zero), _mm256_unpacklo_epi8(white, zero));
+            const __m256i diffHi = _mm256_sub_epi16(_mm256_unpackhi_epi8(black, zero), _mm256_unpackhi_epi8(white, zero));
+            __m256i maxLo = _mm256_max_epi16(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(diffLo, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0)),
+                                             _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(diffLo, _MM_SHUFFLE(1, 1, 1, 1)), _MM_SHUFFLE(1, 1, 1, 1)));
+            maxLo = _mm256_max_epi16(maxLo, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(diffLo, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 2, 2, 2)));
+            __m256i maxHi = _mm256_max_epi16(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(diffHi, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0)),
+                                             _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(diffHi, _MM_SHUFFLE(1, 1, 1, 1)), _MM_SHUFFLE(1, 1, 1, 1)));
+            maxHi = _mm256_max_epi16(maxHi, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(diffHi, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 2, 2, 2)));
+            const __m256i alpha = _mm256_packus_epi16(_mm256_and_si256(_mm256_add_epi16(maxLo, offset), lowByte),
+                                                      _mm256_and_si256(_mm256_add_epi16(maxHi, offset), lowByte));
+            result = _mm256_or_si256(_mm256_andnot_si256(alphaMask, result), _mm256_and_si256(alphaMask, alpha));
+        }
+        _mm256_storeu_si256(dst, result);
+    }
+    qt_gtk_render_theme_generic(bdata + i * 4, wdata ? wdata + i * 4 : nullptr, pixelCount - i);
+}
+#endif
+
+QGtkRenderThemeFunction qt_gtk_resolve_render_theme()
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (qCpuHasFeature(AVX2))
+        return qt_gtk_render_theme_avx2;
+#endif
+#if defined(__SSE2__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return qt_gtk_render_theme_sse2;
+#else
+    return qt_gtk_render_theme_generic;
+#endif
+}
+
+QList<QGtkRenderThemeKernel> qt_gtk_render_theme_kernels()
+{
+    QList<QGtkRenderThemeKernel> kernels;
+    kernels.append({ "generic", qt_gtk_render_theme_generic });
+#if defined(__SSE2__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    kernels.append({ "sse2", qt_gtk_render_theme_sse2 });
+#endif
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (qCpuHasFeature(AVX2))
+        kernels.append({ "avx2", qt_gtk_render_theme_avx2 });
+#endif
+    return kernels;
+}
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef QGTKRENDERTHEME_P_H
+#define QGTKRENDERTHEME_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGlobal>
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QList>
+#include "qgtkglobal_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// To recover alpha we apply the gtk painting function two times to
+// white, and black window backgrounds. This can be used to
+// recover the premultiplied alpha channel. The kernels also convert
+// the GTK+ byte order into the Qt one in place; wdata is nullptr when
+// alpha is not wanted.
+typedef void (*QGtkRenderThemeFunction)(uchar *bdata, const uchar *wdata, int pixelCount);
+
+struct QGtkRenderThemeKernel
+{
+    const char *name;
+    QGtkRenderThemeFunction function;
+};
+
+// The scalar reference kernel.
+void qt_gtk_render_theme_generic(uchar *bdata, const uchar *wdata, int pixelCount);
+// The fastest kernel this CPU can run.
+QGtkRenderThemeFunction qt_gtk_resolve_render_theme();
+// Every kernel this CPU can run, the generic one first.
+QList<QGtkRenderThemeKernel> qt_gtk_render_theme_kernels();
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
+
+#endif // QGTKRENDERTHEME_P_H
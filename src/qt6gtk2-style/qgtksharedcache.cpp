@@ -0,0 +1,349 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+
+#include "qgtksharedcache_p.h"
+
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QImage>
+#include <QDir>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "qgtkdiskcache_p.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+enum SlotState : quint32
+{
+    EmptySlot,
+    BusySlot,
+    ReadySlot
+};
+
+// Segment layout: header, slot table, then the pixels of each entry with
+// width * 4 byte rows. A process claims an empty slot with a
+// compare-and-swap, fills it and marks it ready; from then on neither the
+// slot nor its pixels change, so readers take no lock. A process dying
+// between the claim and the ready store leaves the slot busy; its owner
+// is recorded, so another process takes the slot over once the owner is
+// gone. The pixel space it took is lost.
+struct QGtkSharedCacheHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 slotCount;
+    quint64 stamp;
+    quint64 dataOffset;
+    quint64 dataSize;
+    std::atomic<quint64> dataUsed;
+    std::atomic<quint32> ready;
+    quint32 reserved;
+};
+
+struct QGtkSharedCacheSlot
+{
+    std::atomic<quint32> state;
+    std::atomic<qint32> owner; // pid of the process filling a busy slot, 0 while unknown
+    quint32 format;
+    qint32 width;
+    qint32 height;
+    quint32 reserved;
+    quint64 offset;
+    QGtkStableKey key;
+};
+
+// The atomics are shared between processes, that only works without locks
+static_assert(std::atomic<quint64>::is_always_lock_free && std::atomic<quint32>::is_always_lock_free
+              && std::atomic<qint32>::is_always_lock_free,
+              "QGtkSharedCache needs lock free atomics");
+
+static const char qt_gtk_shared_magic[8] = { 'Q', 'T', '6', 'G', 'T', 'K', '2', 'S' };
+// Bump when QGtkPainterKey, the rendering or the segment layout change
+static const quint32 qt_gtk_shared_version = 3;
+// A power of two; slots are probed linearly from the key hash
+static const quint32 qt_gtk_shared_slots = 16384;
+static const quint32 qt_gtk_shared_probes = 32;
+// Only the pages actually written take memory
+static const quint64 qt_gtk_shared_size = 64 * 1024 * 1024;
+
+struct QGtkSharedCacheData
+{
+    QGtkSharedCacheData()
+        : enabled(qgetenv("QT6GTK2_SHARED_CACHE") == "1")
+    {
+    }
+
+    bool attach();
+    bool isReady();
+
+    bool enabled;
+    bool attached = false;
+    bool checked = false;
+    bool valid = false;
+    QByteArray name;
+    uchar *data = nullptr;
+    QGtkSharedCacheHeader *header = nullptr;
+    QGtkSharedCacheSlot *slots = nullptr;
+};
+
+}
+
+Q_GLOBAL_STATIC(QGtkSharedCacheData, sharedCache)
+
+// Display name usable in a segment name, such as "_0_0" for ":0.0"
+static QByteArray qt_gtk_display_name()
+{
+    GdkDisplay *display = gdk_display_get_default();
+    QByteArray name = display ? QByteArray(gdk_display_get_name(display)) : QByteArray();
+    for (char &c : name) {
+        if (!isalnum(uchar(c)))
+            c = '_';
+    }
+    return name;
+}
+
+// Depth of the visual elements are rendered with
+static int qt_gtk_visual_depth()
+{
+    GdkScreen *screen = gdk_screen_get_default();
+    if (!screen)
+        return 0;
+    GdkVisual *visual = gdk_screen_get_rgba_visual(screen);
+    if (!visual || qgetenv("QT6GTK2_ARGB_RENDERING") == "0")
+        visual = gdk_screen_get_system_visual(screen);
+    return visual ? gdk_visual_get_depth(visual) : 0;
+}
+
+// Removes the segments of earlier generations for the same display and
+// depth. Processes still on them keep their mapping. Segments are only
+// listed where they show up in /dev/shm, elsewhere they stay until the
+// next reboot.
+static void qt_gtk_unlink_siblings(const QByteArray &prefix, const QByteArray &name)
+{
+    const QStringList entries = QDir(QLatin1String("/dev/shm")).entryList(
+                QStringList(QString::fromLatin1(prefix) + QLatin1Char('*')), QDir::Files | QDir::System);
+    for (const QString &entry : entries) {
+        const QByteArray sibling = '/' + entry.toLatin1();
+        if (sibling != name)
+            shm_unlink(sibling.constData());
+    }
+}
+
+bool QGtkSharedCacheData::attach()
+{
+    if (attached)
+        return data;
+    attached = true;
+    if (!enabled)
+        return false;
+
+    // One segment per user, display, visual depth and theme state, the
+    // stamp is the generation
+    const quint64 stamp = QGtkDiskCache::themeStamp();
+    const quint64 generation = qt_gtk_stable_hash(&qt_gtk_shared_version, sizeof(qt_gtk_shared_version), stamp);
+    const QByteArray prefix = "qt6gtk2-" + QByteArray::number(getuid()) + '-' + qt_gtk_display_name()
+            + '-' + QByteArray::number(qt_gtk_visual_depth()) + '-';
+    name = '/' + prefix + QByteArray::number(generation, 16);
+
+    bool created = true;
+    int fd = shm_open(name.constData(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        created = false;
+        fd = shm_open(name.constData(), O_RDWR, 0600);
+    }
+    if (fd < 0)
+        return false;
+
+    // The creator may not have sized the segment yet; resizing it to the
+    // same size again keeps whatever it wrote already
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && st.st_uid == getuid();
+    if (ok && quint64(st.st_size) != qt_gtk_shared_size)
+        ok = st.st_size == 0 && ftruncate(fd, qt_gtk_shared_size) == 0;
+    void *mapped = ok ? mmap(nullptr, qt_gtk_shared_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    data = static_cast<uchar *>(mapped);
+    header = reinterpret_cast<QGtkSharedCacheHeader *>(data);
+    slots = reinterpret_cast<QGtkSharedCacheSlot *>(header + 1);
+
+    if (created) {
+        const quint64 offset = sizeof(QGtkSharedCacheHeader) + qt_gtk_shared_slots * sizeof(QGtkSharedCacheSlot);
+        memcpy(header->magic, qt_gtk_shared_magic, sizeof(header->magic));
+        header->version = qt_gtk_shared_version;
+        header->slotCount = qt_gtk_shared_slots;
+        header->stamp = stamp;
+        header->dataOffset = (offset + 4095) & ~quint64(4095);
+        header->dataSize = qt_gtk_shared_size - header->dataOffset;
+        header->ready.store(1, std::memory_order_release);
+        qt_gtk_unlink_siblings(prefix, name);
+    }
+    return true;
+}
+
+bool QGtkSharedCacheData::isReady()
+{
+    if (checked)
+        return valid;
+    if (!attach() || !header->ready.load(std::memory_order_acquire))
+        return false;
+
+    checked = true;
+    valid = !memcmp(header->magic, qt_gtk_shared_magic, sizeof(header->magic))
+            && header->version == qt_gtk_shared_version && header->slotCount == qt_gtk_shared_slots
+            && header->dataOffset >= sizeof(QGtkSharedCacheHeader) + qt_gtk_shared_slots * sizeof(QGtkSharedCacheSlot)
+            && header->dataOffset + header->dataSize == qt_gtk_shared_size;
+    return valid;
+}
+
+// Takes over a busy slot whose owner died before publishing it
+static bool qt_gtk_claim_orphan(QGtkSharedCacheSlot &slot)
+{
+    qint32 owner = slot.owner.load(std::memory_order_acquire);
+    if (owner <= 0 || owner == getpid() || kill(owner, 0) == 0 || errno != ESRCH)
+        return false;
+    return slot.owner.compare_exchange_strong(owner, getpid(), std::memory_order_acq_rel);
+}
+
+static quint64 qt_gtk_shared_hash(const QGtkStableKey &key)
+{
+    // qHash() is seeded per process
+    return qt_gtk_stable_hash(&key, sizeof(key));
+}
+
+bool QGtkSharedCache::find(const QGtkPainterKey &key, QPixmap *pixmap)
+{
+    QGtkSharedCacheData *d = sharedCache();
+    if (!d->isReady())
+        return false;
+
+    const QGtkStableKey stable = QGtkPainter::stableKey(key);
+    const quint64 hash = qt_gtk_shared_hash(stable);
+    for (quint32 i = 0; i < qt_gtk_shared_probes; ++i) {
+        const QGtkSharedCacheSlot &slot = d->slots[(hash + i) & (qt_gtk_shared_slots - 1)];
+        const quint32 state = slot.state.load(std::memory_order_acquire);
+        if (state == EmptySlot)
+            return false;
+        if (state != ReadySlot || !(slot.key == stable))
+            continue;
+
+        // other processes write the table, so a slot in another pixel
+        // layout is dropped as one past the mapping is
+        if (slot.format != QImage::Format_RGB32 && slot.format != QImage::Format_ARGB32_Premultiplied)
+            return false;
+        const quint64 bytes = quint64(slot.width) * slot.height * 4;
+        if (slot.width <= 0 || slot.height <= 0 || slot.offset < d->header->dataOffset
+                || slot.offset > qt_gtk_shared_size || bytes > qt_gtk_shared_size - slot.offset)
+            return false;
+        // the mapping is shared, const data makes Qt copy before any write
+        const uchar *data = d->data + slot.offset;
+        const QImage image(data, slot.width, slot.height, slot.width * 4, QImage::Format(slot.format));
+        *pixmap = QPixmap::fromImage(image);
+        pixmap->setDevicePixelRatio(key.dpr / 100.0);
+        return !pixmap->isNull();
+    }
+    return false;
+}
+
+void QGtkSharedCache::insert(const QGtkPainterKey &key, const QPixmap &pixmap)
+{
+    QGtkSharedCacheData *d = sharedCache();
+    if (!d->isReady())
+        return;
+
+    QImage image = pixmap.toImage();
+    if (image.format() != QImage::Format_RGB32)
+        image.convertTo(QImage::Format_ARGB32_Premultiplied);
+    const quint64 bytes = quint64(image.width()) * image.height() * 4;
+    const quint64 aligned = (bytes + 15) & ~quint64(15);
+    if (image.isNull() || d->header->dataUsed.load(std::memory_order_relaxed) + aligned > d->header->dataSize)
+        return;
+
+    // Claim a slot before taking space, so that a full table wastes none
+    const QGtkStableKey stable = QGtkPainter::stableKey(key);
+    const quint64 hash = qt_gtk_shared_hash(stable);
+    QGtkSharedCacheSlot *slot = nullptr;
+    for (quint32 i = 0; i < qt_gtk_shared_probes && !slot; ++i) {
+        QGtkSharedCacheSlot &candidate = d->slots[(hash + i) & (qt_gtk_shared_slots - 1)];
+        quint32 state = candidate.state.load(std::memory_order_acquire);
+        if (state == EmptySlot
+                && candidate.state.compare_exchange_strong(state, BusySlot, std::memory_order_acq_rel)) {
+            candidate.owner.store(getpid(), std::memory_order_release);
+            slot = &candidate;
+        } else if (state == BusySlot && qt_gtk_claim_orphan(candidate)) {
+            slot = &candidate;
+        } else if (state == ReadySlot && candidate.key == stable) {
+            return; // published by another process meanwhile
+        }
+    }
+    if (!slot)
+        return;
+
+    const quint64 offset = d->header->dataUsed.fetch_add(aligned, std::memory_order_relaxed);
+    if (offset + aligned > d->header->dataSize) {
+        slot->owner.store(0, std::memory_order_relaxed);
+        slot->state.store(EmptySlot, std::memory_order_release);
+        return;
+    }
+
+    slot->offset = d->header->dataOffset + offset;
+    slot->width = image.width();
+    slot->height = image.height();
+    slot->format = image.format();
+    slot->key = stable;
+    uchar *pixels = d->data + slot->offset;
+    for (int y = 0; y < image.height(); ++y)
+        memcpy(pixels + y * image.width() * 4, image.constScanLine(y), image.width() * 4);
+    slot->state.store(ReadySlot, std::memory_order_release);
+}
+
+void QGtkSharedCache::detach()
+{
+    if (!sharedCache.exists())
+        return;
+    QGtkSharedCacheData *d = sharedCache();
+    if (d->data) {
+        // After a theme change the segment is stale for everyone; processes
+        // still using it keep their mapping, new ones start a new segment
+        if (d->isReady() && d->header->stamp != QGtkDiskCache::themeStamp())
+            shm_unlink(d->name.constData());
+        munmap(d->data, qt_gtk_shared_size);
+    }
+    d->data = nullptr;
+    d->header = nullptr;
+    d->slots = nullptr;
+    d->attached = false;
+    d->checked = false;
+    d->valid = false;
+}
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
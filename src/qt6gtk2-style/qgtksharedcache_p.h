@@ -0,0 +1,64 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+
+#ifndef QGTKSHAREDCACHE_P_H
+#define QGTKSHAREDCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGlobal>
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QPixmap>
+#include "qgtkpainter_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Shares rendered elements between the running applications of a user
+// through a POSIX shared memory segment per theme state. The first
+// process to render an element publishes it, the others use the same
+// pixels instead of asking GTK again. The segment is named after the
+// display, the visual depth and the theme stamp, so a theme or font
+// change moves every process to a new, empty segment; the one creating
+// it removes the older ones. Entries are never removed; once the segment
+// is full nothing new is published. QT6GTK2_SHARED_CACHE=1 enables it.
+class QGtkSharedCache
+{
+public:
+    static bool find(const QGtkPainterKey &key, QPixmap *pixmap);
+    static void insert(const QGtkPainterKey &key, const QPixmap &pixmap);
+    // Leaves the segment, removing it if the theme changed since
+    static void detach();
+};
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
+
+#endif // QGTKSHAREDCACHE_P_H
@@ -0,0 +1,196 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+
+#include "qgtkshmreadback_p.h"
+
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QByteArray>
+#include <gdk/gdkx.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+struct QGtkShmReadbackData
+{
+    QGtkShmReadbackData()
+        : enabled(Q_BYTE_ORDER == Q_LITTLE_ENDIAN && qgetenv("QT6GTK2_SHM_READBACK") != "0")
+    {
+        info.shmid = -1;
+        info.shmaddr = nullptr;
+    }
+
+    ~QGtkShmReadbackData()
+    {
+        // The display may be gone already, the segment is freed once detached
+        if (info.shmaddr)
+            shmdt(info.shmaddr);
+        if (image) {
+            image->data = nullptr;
+            XDestroyImage(image);
+        }
+    }
+
+    bool allocate(GdkWindow *window, int width, int height);
+    void release();
+
+    bool enabled;
+    bool checked = false;
+    bool available = false;
+    Display *display = nullptr;
+    XShmSegmentInfo info;
+    XImage *image = nullptr;
+};
+
+}
+
+Q_GLOBAL_STATIC(QGtkShmReadbackData, shmReadback)
+
+// Creates a segment of at least width x height for the visual of window;
+// the first time also checks that the server can attach it at all
+bool QGtkShmReadbackData::allocate(GdkWindow *window, int width, int height)
+{
+    if (image && image->width >= width && image->height >= height)
+        return true;
+    if (image) {
+        width = qMax(width, image->width);
+        height = qMax(height, image->height);
+    }
+    release();
+
+    display = GDK_WINDOW_XDISPLAY(window);
+    Visual *visual = GDK_VISUAL_XVISUAL(gdk_drawable_get_visual(GDK_DRAWABLE(window)));
+    const int depth = gdk_drawable_get_depth(GDK_DRAWABLE(window));
+    image = XShmCreateImage(display, visual, depth, ZPixmap, nullptr, &info, width, height);
+    if (!image)
+        return false;
+
+    // Only the common 32 bit layout is handled, anything else is left to GDK
+    if (image->bits_per_pixel != 32 || image->byte_order != LSBFirst || image->red_mask != 0xff0000
+            || image->green_mask != 0xff00 || image->blue_mask != 0xff) {
+        release();
+        return false;
+    }
+
+    info.shmid = shmget(IPC_PRIVATE, size_t(image->bytes_per_line) * image->height, IPC_CREAT | 0600);
+    if (info.shmid < 0) {
+        release();
+        return false;
+    }
+    info.shmaddr = image->data = static_cast<char *>(shmat(info.shmid, nullptr, 0));
+    info.readOnly = False;
+    if (info.shmaddr == reinterpret_cast<char *>(-1)) {
+        info.shmaddr = image->data = nullptr;
+        shmctl(info.shmid, IPC_RMID, nullptr);
+        info.shmid = -1;
+        release();
+        return false;
+    }
+
+    // Over a remote connection attaching fails with an X error
+    gdk_error_trap_push();
+    const bool attached = XShmAttach(display, &info);
+    XSync(display, False);
+    const bool failed = gdk_error_trap_pop() || !attached;
+    // Removed now, so the segment goes away with the last process using it
+    shmctl(info.shmid, IPC_RMID, nullptr);
+    if (failed) {
+        shmdt(info.shmaddr);
+        info.shmaddr = image->data = nullptr;
+        info.shmid = -1;
+        release();
+        return false;
+    }
+    return true;
+}
+
+void QGtkShmReadbackData::release()
+{
+    if (info.shmaddr) {
+        XShmDetach(display, &info);
+        XSync(display, False);
+        shmdt(info.shmaddr);
+    }
+    info.shmaddr = nullptr;
+    info.shmid = -1;
+    if (image) {
+        image->data = nullptr;
+        XDestroyImage(image);
+    }
+    image = nullptr;
+}
+
+bool QGtkShmReadback::read(GdkWindow *window, GdkPixmap *pixmap, int width, int height, uchar *data)
+{
+    QGtkShmReadbackData *d = shmReadback();
+    if (!d->enabled || (d->checked && !d->available))
+        return false;
+    if (!d->checked) {
+        d->checked = true;
+        d->available = XShmQueryExtension(GDK_WINDOW_XDISPLAY(window));
+        if (!d->available)
+            return false;
+    }
+    if (!d->allocate(window, width, height)) {
+        // Remote displays fail right away, there is no point in retrying
+        d->available = false;
+        return false;
+    }
+
+    // The server fills the image size, read only the part asked for
+    const int imageWidth = d->image->width;
+    const int imageHeight = d->image->height;
+    const int bytesPerLine = d->image->bytes_per_line;
+    d->image->width = width;
+    d->image->height = height;
+    d->image->bytes_per_line = width * 4;
+    const bool ok = XShmGetImage(d->display, GDK_PIXMAP_XID(pixmap), d->image, 0, 0, AllPlanes);
+    d->image->width = imageWidth;
+    d->image->height = imageHeight;
+    d->image->bytes_per_line = bytesPerLine;
+    if (!ok)
+        return false;
+
+    // B, G, R, X bytes to the R, G, B, A of a GdkPixbuf
+    const quint32 *src = reinterpret_cast<const quint32 *>(d->image->data);
+    quint32 *dst = reinterpret_cast<quint32 *>(data);
+    const qsizetype count = qsizetype(width) * height;
+    for (qsizetype i = 0; i < count; ++i) {
+        const quint32 pixel = src[i];
+        dst[i] = 0xff000000 | ((pixel & 0xff) << 16) | (pixel & 0xff00) | ((pixel >> 16) & 0xff);
+    }
+    return true;
+}
+
+void QGtkShmReadback::release()
+{
+    if (shmReadback.exists())
+        shmReadback()->release();
+}
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
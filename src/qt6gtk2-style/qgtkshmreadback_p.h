@@ -0,0 +1,61 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+
+#ifndef QGTKSHMREADBACK_P_H
+#define QGTKSHMREADBACK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGlobal>
+#if !defined(QT_NO_STYLE_GTK)
+
+#include "qgtkglobal_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Reads drawables back through a MIT-SHM segment instead of the X
+// connection. The segment is reused and grows to the largest element
+// read. It is only used when the server can attach it, so remote
+// displays keep using gdk_pixbuf_get_from_drawable().
+// QT6GTK2_SHM_READBACK=0 disables it.
+class QGtkShmReadback
+{
+public:
+    // Reads the top left width x height pixels of pixmap, which must have
+    // the depth of window, into data as width * 4 byte rows in the byte
+    // order of a GdkPixbuf. Returns false when it could not.
+    static bool read(GdkWindow *window, GdkPixmap *pixmap, int width, int height, uchar *data);
+    static void release();
+};
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
+
+#endif // QGTKSHMREADBACK_P_H
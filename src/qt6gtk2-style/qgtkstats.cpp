@@ -0,0 +1,174 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+
+#include "qgtkstats_p.h"
+
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+// Not Q_LOGGING_CATEGORY, QT6GTK2_STATS=1 needs to enable it
+static QLoggingCategory &qt_gtk_stats_category()
+{
+    static QLoggingCategory category("qt6gtk2.stats");
+    return category;
+}
+
+const QLoggingCategory &lcGtkStats()
+{
+    return qt_gtk_stats_category();
+}
+
+namespace {
+
+// By element and detail text, the same detail may come from several literals
+typedef QPair<int, QString> QGtkStatsKey;
+
+struct QGtkStatsEntry
+{
+    quint64 paints = 0;
+    quint64 misses = 0;
+    qint64 nsecs[3] = { 0, 0, 0 };
+    qint64 bytes = 0;
+};
+
+struct QGtkStatsData
+{
+    QHash<QGtkStatsKey, QGtkStatsEntry> entries;
+    QGtkStatsKey current = QGtkStatsKey(-1, QString());
+    bool currentMissed = false;
+};
+
+// Same order as QGtkPainter::Element
+static const char *const qt_gtk_paint_functions[] = {
+    "paintBox", "paintBoxGap", "paintHline", "paintVline", "paintExpander", "paintFocus",
+    "paintResizeGrip", "paintArrow", "paintHandle", "paintSlider", "paintShadow", "paintFlatBox",
+    "paintExtention", "paintOption", "paintCheckbox"
+};
+
+}
+
+Q_GLOBAL_STATIC(QGtkStatsData, statsData)
+
+static bool qt_gtk_stats_enabled()
+{
+    if (qgetenv("QT6GTK2_STATS") == "1")
+        qt_gtk_stats_category().setEnabled(QtDebugMsg, true);
+    if (!lcGtkStats().isDebugEnabled())
+        return false;
+    qAddPostRoutine(QGtkStats::dump);
+    return true;
+}
+
+static QString qt_gtk_stats_name(const QGtkStatsKey &key)
+{
+    const int count = int(sizeof(qt_gtk_paint_functions) / sizeof(qt_gtk_paint_functions[0]));
+    const QString function = key.first >= 0 && key.first < count ? QLatin1String(qt_gtk_paint_functions[key.first])
+                                                                  : QString::number(key.first);
+    return function + QLatin1Char('/') + (key.second.isEmpty() ? QLatin1String("-") : key.second);
+}
+
+bool QGtkStats::isEnabled()
+{
+    static const bool enabled = qt_gtk_stats_enabled();
+    return enabled;
+}
+
+void QGtkStats::paint(int element, const char *detail)
+{
+    QGtkStatsData *d = statsData();
+    d->current = QGtkStatsKey(element, QString::fromLatin1(detail));
+    d->currentMissed = false;
+    ++d->entries[d->current].paints;
+}
+
+void QGtkStats::miss(qint64 bytes)
+{
+    QGtkStatsData *d = statsData();
+    QGtkStatsEntry &entry = d->entries[d->current];
+    // Nine-slice probes and the like render more than once per paint
+    if (!d->currentMissed)
+        ++entry.misses;
+    d->currentMissed = true;
+    entry.bytes += bytes;
+}
+
+void QGtkStats::addTime(Timer counter, QElapsedTimer &timer)
+{
+    if (!timer.isValid())
+        return;
+    statsData()->entries[statsData()->current].nsecs[counter] += timer.nsecsElapsed();
+    timer.start();
+}
+
+QVariantMap QGtkStats::snapshot()
+{
+    QVariantMap stats;
+    if (!statsData.exists())
+        return stats;
+    const QHash<QGtkStatsKey, QGtkStatsEntry> &entries = statsData()->entries;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        QVariantMap entry;
+        entry.insert(QLatin1String("hits"), it->paints - it->misses);
+        entry.insert(QLatin1String("misses"), it->misses);
+        entry.insert(QLatin1String("renderNsecs"), it->nsecs[RenderTime]);
+        entry.insert(QLatin1String("readbackNsecs"), it->nsecs[ReadbackTime]);
+        entry.insert(QLatin1String("convertNsecs"), it->nsecs[ConvertTime]);
+        entry.insert(QLatin1String("bytes"), it->bytes);
+        stats.insert(qt_gtk_stats_name(it.key()), entry);
+    }
+    return stats;
+}
+
+void QGtkStats::dump()
+{
+    if (!statsData.exists())
+        return;
+    const QHash<QGtkStatsKey, QGtkStatsEntry> &entries = statsData()->entries;
+    QList<QGtkStatsKey> keys = entries.keys();
+    // Most expensive first
+    auto total = [&](const QGtkStatsKey &key) {
+        const QGtkStatsEntry &entry = entries[key];
+        return entry.nsecs[RenderTime] + entry.nsecs[ReadbackTime] + entry.nsecs[ConvertTime];
+    };
+    std::sort(keys.begin(), keys.end(), [&](const QGtkStatsKey &a, const QGtkStatsKey &b) {
+        return total(a) > total(b);
+    });
+
+    qCDebug(lcGtkStats, "%-32s %10s %10s %10s %10s %10s %12s", "element/detail", "hits", "misses",
+            "render ms", "readback", "convert", "bytes");
+    for (const QGtkStatsKey &key : std::as_const(keys)) {
+        const QGtkStatsEntry &entry = entries[key];
+        qCDebug(lcGtkStats, "%-32s %10llu %10llu %10.2f %10.2f %10.2f %12lld",
+                qPrintable(qt_gtk_stats_name(key)), entry.paints - entry.misses, entry.misses,
+                entry.nsecs[RenderTime] / 1e6, entry.nsecs[ReadbackTime] / 1e6,
+                entry.nsecs[ConvertTime] / 1e6, entry.bytes);
+    }
+}
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
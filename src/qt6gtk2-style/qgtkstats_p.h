@@ -0,0 +1,79 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+
+#ifndef QGTKSTATS_P_H
+#define QGTKSTATS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGlobal>
+#if !defined(QT_NO_STYLE_GTK)
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QLoggingCategory>
+#include <QVariantMap>
+#include "qgtkglobal_p.h"
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(lcGtkStats)
+
+// Counts the painter's cache hits and misses, the time spent drawing,
+// reading back and converting renders and the bytes rendered, per paint
+// function and GTK detail. Collected when QT6GTK2_STATS=1 is set or the
+// qt6gtk2.stats category is enabled for debug output; either way they are
+// printed through that category when the application quits.
+// QGtkStyle::statistics() returns them at any time.
+class QGtkStats
+{
+public:
+    enum Timer
+    {
+        RenderTime,
+        ReadbackTime,
+        ConvertTime
+    };
+
+    static bool isEnabled();
+    // A paint function was called for element and GTK detail
+    static void paint(int element, const char *detail);
+    // The current paint missed the cache and rendered bytes
+    static void miss(qint64 bytes);
+    // Adds the time elapsed on timer to the current paint and restarts it
+    static void addTime(Timer counter, QElapsedTimer &timer);
+    static QVariantMap snapshot();
+    static void dump();
+};
+
+QT_END_NAMESPACE
+
+#endif //!defined(QT_NO_STYLE_GTK)
+
+#endif // QGTKSTATS_P_H
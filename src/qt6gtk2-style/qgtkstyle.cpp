@@ -46,11 +46,17 @@
 #include <QTreeView>
 #include <QStyledItemDelegate>
 #include <QWizard>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QScreen>
+#include <functional>
 
-#include <QPixmapCache>
 #include <private/qstyleanimation_p.h>
 #undef signals // Collides with GTK stymbols
 #include "qgtkpainter_p.h"
+#include "qgtkpixmapcache_p.h"
+#include "qgtkstats_p.h"
 #include "qstylehelper_p.h"
 #include "qgtkstyle_p_p.h"
 
@@ -324,7 +330,7 @@ QPalette QGtkStyle::standardPalette() const
     QPalette palette = QCommonStyle::standardPalette();
     if (d->isThemeAvailable()) {
         GtkStyle *style = d->gtkStyle();
-        GtkWidget *gtkButton = d->gtkWidget("GtkButton");
+        GtkWidget *gtkButton = d->gtkWidget(QGtkWidgetId::Button);
         GtkWidget *gtkEntry = d->getTextColorWidget();
         GdkColor gdkBg, gdkBase, gdkText, gdkForeground, gdkSbg, gdkSfg, gdkaSbg, gdkaSfg;
         QColor bg, base, text, fg, highlight, highlightText, inactiveHighlight, inactiveHighlightedTExt;
@@ -364,7 +370,7 @@ QPalette QGtkStyle::standardPalette() const
         palette.setColor(QPalette::Base, base);
 
         QColor alternateRowColor = palette.base().color().lighter(93); // ref gtkstyle.c draw_flat_box
-        GtkWidget *gtkTreeView = d->gtkWidget("GtkTreeView");
+        GtkWidget *gtkTreeView = d->gtkWidget(QGtkWidgetId::TreeView);
         GdkColor *gtkAltBase = nullptr;
         gtk_widget_style_get(gtkTreeView, "odd-row-color", &gtkAltBase, nullptr);
         if (gtkAltBase) {
@@ -417,6 +423,123 @@ void QGtkStyle::polish(QPalette &palette)
         palette = palette.resolve(standardPalette());
 }
 
+// Paints the elements most windows start with into offscreen images, so that
+// their first paint events find them cached. The work is split in slices
+// of a few milliseconds which run whenever the event loop is idle.
+static void qt_gtk_warmup_cache(QStyle *style)
+{
+    typedef std::function<void(QPainter *painter)> WarmupJob;
+    QList<WarmupJob> jobs;
+
+    const QFontMetrics fm(QApplication::font());
+    const QPalette palette = QApplication::palette();
+    const QList<QStyle::State> states = {
+        QStyle::State_Enabled,
+        QStyle::State_Enabled | QStyle::State_MouseOver,
+        QStyle::State_Enabled | QStyle::State_HasFocus,
+        QStyle::State_None
+    };
+
+    QStyleOptionButton button;
+    button.palette = palette;
+    button.fontMetrics = fm;
+    button.rect = QRect(QPoint(0, 0), style->sizeFromContents(QStyle::CT_PushButton, &button,
+                                                              QSize(fm.horizontalAdvance(QLatin1String("Cancel")),
+                                                                    fm.height())));
+    QStyleOptionButton indicator = button;
+    indicator.rect = QRect(0, 0, style->pixelMetric(QStyle::PM_IndicatorWidth),
+                           style->pixelMetric(QStyle::PM_IndicatorHeight));
+    QStyleOptionButton exclusiveIndicator = button;
+    exclusiveIndicator.rect = QRect(0, 0, style->pixelMetric(QStyle::PM_ExclusiveIndicatorWidth),
+                                    style->pixelMetric(QStyle::PM_ExclusiveIndicatorHeight));
+
+    for (QStyle::State state : states) {
+        jobs << [=](QPainter *painter) {
+            QStyleOptionButton option = button;
+            option.state = state | QStyle::State_Raised;
+            style->drawPrimitive(QStyle::PE_PanelButtonCommand, &option, painter);
+            option.state = state | QStyle::State_Sunken;
+            style->drawPrimitive(QStyle::PE_PanelButtonCommand, &option, painter);
+        };
+        for (QStyle::State check : { QStyle::State_Off, QStyle::State_On }) {
+            jobs << [=](QPainter *painter) {
+                QStyleOptionButton option = indicator;
+                option.state = state | check;
+                style->drawPrimitive(QStyle::PE_IndicatorCheckBox, &option, painter);
+                option = exclusiveIndicator;
+                option.state = state | check;
+                style->drawPrimitive(QStyle::PE_IndicatorRadioButton, &option, painter);
+            };
+        }
+    }
+
+    const int extent = style->pixelMetric(QStyle::PM_ScrollBarExtent);
+    for (Qt::Orientation orientation : { Qt::Vertical, Qt::Horizontal }) {
+        jobs << [=](QPainter *painter) {
+            QStyleOptionSlider option;
+            option.palette = palette;
+            option.state = QStyle::State_Enabled;
+            option.orientation = orientation;
+            if (orientation == Qt::Horizontal)
+                option.state |= QStyle::State_Horizontal;
+            option.rect = orientation == Qt::Vertical ? QRect(0, 0, extent, 200) : QRect(0, 0, 200, extent);
+            option.minimum = 0;
+            option.maximum = 100;
+            option.pageStep = 10;
+            option.subControls = QStyle::SC_All;
+            style->drawComplexControl(QStyle::CC_ScrollBar, &option, painter);
+        };
+    }
+
+    jobs << [=](QPainter *painter) {
+        QStyleOptionFrame option;
+        option.palette = palette;
+        option.state = QStyle::State_Enabled | QStyle::State_Sunken;
+        option.lineWidth = style->pixelMetric(QStyle::PM_DefaultFrameWidth);
+        option.rect = QRect(0, 0, 150, fm.height() + 2 * option.lineWidth + 4);
+        style->drawPrimitive(QStyle::PE_PanelLineEdit, &option, painter);
+    };
+
+    jobs << [=](QPainter *painter) {
+        QStyleOptionMenuItem option;
+        option.palette = palette;
+        option.fontMetrics = fm;
+        option.state = QStyle::State_Enabled;
+        option.rect = QRect(0, 0, 200, 300);
+        style->drawPrimitive(QStyle::PE_PanelMenu, &option, painter);
+        option.menuItemType = QStyleOptionMenuItem::Normal;
+        option.text = QLatin1String("Item");
+        option.rect = QRect(QPoint(0, 0), style->sizeFromContents(QStyle::CT_MenuItem, &option,
+                                                                  QSize(200, fm.height())));
+        style->drawControl(QStyle::CE_MenuItem, &option, painter);
+        option.state |= QStyle::State_Selected;
+        style->drawControl(QStyle::CE_MenuItem, &option, painter);
+    };
+
+    // Paint on a single pixel, all we are after are the cache entries
+    const qreal dpr = QGuiApplication::primaryScreen() ? QGuiApplication::primaryScreen()->devicePixelRatio() : 1.0;
+    QPointer<QStyle> guard(style);
+    QTimer *timer = new QTimer(qApp);
+    timer->setInterval(0);
+    int next = 0;
+    QObject::connect(timer, &QTimer::timeout, timer, [=]() mutable {
+        if (!guard || QApplication::style() != guard) {
+            timer->deleteLater();
+            return;
+        }
+        QImage image(1, 1, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(dpr);
+        QPainter painter(&image);
+        QElapsedTimer elapsed;
+        elapsed.start();
+        while (next < jobs.size() && elapsed.elapsed() < 4)
+            jobs.at(next++)(&painter);
+        if (next == jobs.size())
+            timer->deleteLater();
+    });
+    timer->start();
+}
+
 /*!
     \reimp
 */
@@ -434,6 +557,9 @@ void QGtkStyle::polish(QApplication *app)
         d->applyCustomPaletteHash();
         if (!d->isKDE4Session())
             qApp->installEventFilter(&d->filter);
+        // Opt-in, as it costs start up time of applications that show no window
+        if (qgetenv("QT6GTK2_WARMUP") == "1")
+            qt_gtk_warmup_cache(this);
     }
 }
 
@@ -445,12 +571,25 @@ void QGtkStyle::unpolish(QApplication *app)
     Q_D(QGtkStyle);
 
     QCommonStyle::unpolish(app);
-    QPixmapCache::clear();
+    QGtkPixmapCache::clear();
+    QGtkStylePrivate::gtkPainter()->clearCaches();
 
     if (app->desktopSettingsAware() && d->isThemeAvailable() && !d->isKDE4Session())
         qApp->removeEventFilter(&d->filter);
 }
 
+/*!
+    Returns the cache hits and misses, the rendering, readback and
+    conversion times in nanoseconds and the bytes rendered, keyed by paint
+    function and GTK detail, for example "paintBox/button". It is empty
+    unless QT6GTK2_STATS=1 is set or the qt6gtk2.stats logging category is
+    enabled. Applications can call it through QMetaObject::invokeMethod().
+*/
+QVariantMap QGtkStyle::statistics() const
+{
+    return QGtkStats::snapshot();
+}
+
 /*!
     \reimp
 */
@@ -526,28 +665,20 @@ int QGtkStyle::pixelMetric(PixelMetric metric,
         return 0;
 
     case PM_ButtonShiftHorizontal: {
-        GtkWidget *gtkButton = d->gtkWidget("GtkButton");
-        guint horizontal_shift;
-        gtk_widget_style_get(gtkButton, "child-displacement-x", &horizontal_shift, nullptr);
-        return horizontal_shift;
+        return d->styleProperties(QGtkWidgetId::Button).childDisplacementX;
     }
 
     case PM_ButtonShiftVertical: {
-        GtkWidget *gtkButton = d->gtkWidget("GtkButton");
-        guint vertical_shift;
-        gtk_widget_style_get(gtkButton, "child-displacement-y", &vertical_shift, nullptr);
-        return vertical_shift;
+        return d->styleProperties(QGtkWidgetId::Button).childDisplacementY;
     }
 
     case PM_MenuBarPanelWidth:
         return 0;
 
     case PM_MenuPanelWidth: {
-        GtkWidget *gtkMenu = d->gtkWidget("GtkMenu");
-        guint horizontal_padding = 0;
+        GtkWidget *gtkMenu = d->gtkWidget(QGtkWidgetId::Menu);
         // horizontal-padding is used by Maemo to get thicker borders
-        if (!gtk_check_version(2, 10, 0))
-            gtk_widget_style_get(gtkMenu, "horizontal-padding", &horizontal_padding, nullptr);
+        const int horizontal_padding = d->styleProperties(QGtkWidgetId::Menu).horizontalPadding;
         int padding = qMax<int>(gtk_widget_get_style(gtkMenu)->xthickness, horizontal_padding);
         return padding;
     }
@@ -600,60 +731,43 @@ int QGtkStyle::pixelMetric(PixelMetric metric,
 
     case PM_SliderThickness:
     case PM_SliderControlThickness: {
-        GtkWidget *gtkScale = d->gtkWidget("GtkHScale");
-        gint val;
-        gtk_widget_style_get(gtkScale, "slider-width", &val, nullptr);
+        GtkWidget *gtkScale = d->gtkWidget(QGtkWidgetId::HScale);
+        const gint val = d->styleProperties(QGtkWidgetId::HScale).sliderWidth;
         if (metric == PM_SliderControlThickness)
             return val + 2*gtk_widget_get_style(gtkScale)->ythickness;
         return val;
     }
 
     case PM_ScrollBarExtent: {
-        gint sliderLength;
-        gint trough_border;
-        GtkWidget *hScrollbar = d->gtkWidget("GtkHScrollbar");
-        gtk_widget_style_get(hScrollbar,
-                               "trough-border",   &trough_border,
-                               "slider-width",    &sliderLength,
-                               nullptr);
-        return sliderLength + trough_border*2;
+        const QGtkStyleProperties &properties = d->styleProperties(QGtkWidgetId::HScrollbar);
+        return properties.sliderWidth + properties.troughBorder*2;
     }
 
     case PM_ScrollBarSliderMin:
         return 34;
 
     case PM_SliderLength:
-        gint val;
-        gtk_widget_style_get(d->gtkWidget("GtkHScale"), "slider-length", &val, nullptr);
-        return val;
+        return d->styleProperties(QGtkWidgetId::HScale).sliderLength;
 
     case PM_ExclusiveIndicatorWidth:
     case PM_ExclusiveIndicatorHeight:
     case PM_IndicatorWidth:
     case PM_IndicatorHeight: {
-        GtkWidget *gtkCheckButton = d->gtkWidget("GtkCheckButton");
-        gint size, spacing;
-        gtk_widget_style_get(gtkCheckButton, "indicator-spacing", &spacing, "indicator-size", &size, nullptr);
-        return size + 2 * spacing;
+        const QGtkStyleProperties &properties = d->styleProperties(QGtkWidgetId::CheckButton);
+        return properties.indicatorSize + 2 * properties.indicatorSpacing;
     }
 
     case PM_MenuBarVMargin: {
-        GtkWidget *gtkMenubar = d->gtkWidget("GtkMenuBar");
+        GtkWidget *gtkMenubar = d->gtkWidget(QGtkWidgetId::MenuBar);
         return qMax(0, gtk_widget_get_style(gtkMenubar)->ythickness);
     }
     case PM_ScrollView_ScrollBarSpacing:
     {
-        gint spacing = 3;
-        GtkWidget *gtkScrollWindow = d->gtkWidget("GtkScrolledWindow");
-        Q_ASSERT(gtkScrollWindow);
-        gtk_widget_style_get(gtkScrollWindow, "scrollbar-spacing", &spacing, nullptr);
-        return spacing;
+        Q_ASSERT(d->gtkWidget(QGtkWidgetId::ScrolledWindow));
+        return d->styleProperties(QGtkWidgetId::ScrolledWindow).scrollbarSpacing;
     }
     case PM_SubMenuOverlap: {
-        gint offset = 0;
-        GtkWidget *gtkMenu = d->gtkWidget("GtkMenu");
-        gtk_widget_style_get(gtkMenu, "horizontal-offset", &offset, nullptr);
-        return offset;
+        return d->styleProperties(QGtkWidgetId::Menu).horizontalOffset;
     }
     case PM_ToolTipLabelFrameWidth:
         return 2;
@@ -760,7 +874,7 @@ int QGtkStyle::styleHint(StyleHint hint, const QStyleOption *option, const QWidg
     {
         if (d->isKDE4Session())
             return QCommonStyle::styleHint(hint, option, widget, returnData);
-        GtkWidget *gtkToolbar = d->gtkWidget("GtkToolbar");
+        GtkWidget *gtkToolbar = d->gtkWidget(QGtkWidgetId::Toolbar);
         GtkToolbarStyle toolbar_style = GTK_TOOLBAR_ICONS;
         g_object_get(gtkToolbar, "toolbar-style", &toolbar_style, nullptr);
         switch (toolbar_style) {
@@ -783,10 +897,7 @@ int QGtkStyle::styleHint(StyleHint hint, const QStyleOption *option, const QWidg
         return int(false);
 
     case SH_ComboBox_Popup: {
-        GtkWidget *gtkComboBox = d->gtkWidget("GtkComboBox");
-        gboolean appears_as_list;
-        gtk_widget_style_get((GtkWidget*)gtkComboBox, "appears-as-list", &appears_as_list, nullptr);
-        return appears_as_list ? 0 : 1;
+        return d->styleProperties(QGtkWidgetId::ComboBox).appearsAsList ? 0 : 1;
     }
 
     case SH_MenuBar_AltKeyNavigation:
@@ -806,10 +917,8 @@ int QGtkStyle::styleHint(StyleHint hint, const QStyleOption *option, const QWidg
         gboolean scrollbars_within_bevel = false;
         if (widget && widget->isWindow())
             scrollbars_within_bevel = true;
-        else if (!gtk_check_version(2, 12, 0)) {
-            GtkWidget *gtkScrollWindow = d->gtkWidget("GtkScrolledWindow");
-            gtk_widget_style_get(gtkScrollWindow, "scrollbars-within-bevel", &scrollbars_within_bevel, nullptr);
-        }
+        else
+            scrollbars_within_bevel = d->styleProperties(QGtkWidgetId::ScrolledWindow).scrollbarsWithinBevel;
         return !scrollbars_within_bevel;
     }
 
@@ -872,7 +981,7 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
         QRect pmRect(QPoint(0,0), QSize(pmSize, pmSize));
 
         // Only draw through style once
-        if (!QPixmapCache::find(pmKey, &pixmap)) {
+        if (!QGtkPixmapCache::find(pmKey, &pixmap)) {
             pixmap = QPixmap(pmSize, pmSize);
             pixmap.fill(Qt::transparent);
             QPainter pmPainter(&pixmap);
@@ -888,10 +997,10 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
             GtkStyle *style = gtk_rc_get_style_by_paths(gtk_settings_get_default(),
                                      "*.GtkScrolledWindow", "*.GtkScrolledWindow", gtk_window_get_type());
             if (style)
-                gtkPainter->paintShadow(d->gtkWidget("GtkFrame"), "viewport", pmRect,
+                gtkPainter->paintShadow(d->gtkWidget(QGtkWidgetId::Frame), "viewport", pmRect,
                                         option->state & State_Enabled ? GTK_STATE_NORMAL : GTK_STATE_INSENSITIVE,
                                         shadow_type, style);
-            QPixmapCache::insert(pmKey, pixmap);
+            QGtkPixmapCache::insert(pmKey, pixmap);
             gtkPainter->reset(painter);
         }
 
@@ -933,7 +1042,7 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
         break;
 
     case PE_PanelTipLabel: {
-        GtkWidget *gtkWindow = d->gtkWidget("GtkWindow"); // The Murrine Engine currently assumes a widget is passed
+        GtkWidget *gtkWindow = d->gtkWidget(QGtkWidgetId::Window); // The Murrine Engine currently assumes a widget is passed
         style = gtk_rc_get_style_by_paths(gtk_settings_get_default(), "gtk-tooltips", "GtkWindow",
                 gtk_window_get_type());
         gtkPainter->paintFlatBox(gtkWindow, "tooltip", option->rect, GTK_STATE_NORMAL, GTK_SHADOW_NONE, style);
@@ -947,9 +1056,8 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
             painter->fillRect(option->rect, option->palette.window());
             break;
         }
-        GtkShadowType shadow_type;
-        GtkWidget *gtkStatusbarFrame = d->gtkWidget("GtkStatusbar.GtkFrame");
-        gtk_widget_style_get(gtk_widget_get_parent(gtkStatusbarFrame), "shadow-type", &shadow_type, nullptr);
+        GtkWidget *gtkStatusbarFrame = d->gtkWidget(QGtkWidgetId::StatusbarFrame);
+        const GtkShadowType shadow_type = d->styleProperties(QGtkWidgetId::Statusbar).shadowType;
         gtkPainter->paintShadow(gtkStatusbarFrame, "frame", option->rect, GTK_STATE_NORMAL,
                                 shadow_type, gtk_widget_get_style(gtkStatusbarFrame));
     }
@@ -957,7 +1065,7 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
 
     case PE_IndicatorHeaderArrow:
         if (const QStyleOptionHeader *header = qstyleoption_cast<const QStyleOptionHeader *>(option)) {
-            GtkWidget *gtkTreeHeader = d->gtkWidget("GtkTreeView.GtkButton");
+            GtkWidget *gtkTreeHeader = d->gtkWidget(QGtkWidgetId::TreeViewButton);
             GtkStateType state = qt_gtk_state(option);
             style = gtk_widget_get_style(gtkTreeHeader);
             GtkArrowType type = GTK_ARROW_UP;
@@ -979,11 +1087,11 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
             if (qobject_cast<const QAbstractItemView*>(widget)) {
                 // Don't draw anything
             } else if (qobject_cast<const QTabBar*>(widget)) {
-                GtkWidget *gtkNotebook = d->gtkWidget("GtkNotebook");
+                GtkWidget *gtkNotebook = d->gtkWidget(QGtkWidgetId::Notebook);
                 style = gtk_widget_get_style(gtkNotebook);
                 gtkPainter->paintFocus(gtkNotebook, "tab", frameRect.adjusted(-1, 1, 1, 1), GTK_STATE_ACTIVE, style);
             } else {
-                GtkWidget *gtkRadioButton = d->gtkWidget("GtkRadioButton");
+                GtkWidget *gtkRadioButton = d->gtkWidget(QGtkWidgetId::RadioButton);
                 gtkPainter->paintFocus(gtkRadioButton, "radiobutton", frameRect, GTK_STATE_ACTIVE, style);
             }
         }
@@ -997,7 +1105,7 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
             rect.translate(2, 0);
             GtkExpanderStyle openState = GTK_EXPANDER_EXPANDED;
             GtkExpanderStyle closedState = GTK_EXPANDER_COLLAPSED;
-            GtkWidget *gtkTreeView = d->gtkWidget("GtkTreeView");
+            GtkWidget *gtkTreeView = d->gtkWidget(QGtkWidgetId::TreeView);
 
             GtkStateType state = GTK_STATE_NORMAL;
             if (!(option->state & State_Enabled))
@@ -1038,31 +1146,30 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
                 if (!(option->state & State_Selected))
                     break;
             }
-            if (GtkWidget *gtkTreeView = d->gtkWidget("GtkTreeView")) {
+            if (GtkWidget *gtkTreeView = d->gtkWidget(QGtkWidgetId::TreeView)) {
                 const char *detail = "cell_even_ruled";
                 if (vopt && vopt->features & QStyleOptionViewItem::Alternate)
                     detail = "cell_odd_ruled";
                 bool isActive = option->state & State_Active;
-                QString key;
                 if (isActive ) {
                     // Required for active/non-active window appearance
-                    key = QLS("a");
-                    QGtkStylePrivate::QGtkStylePrivate::gtkWidgetSetFocus(gtkTreeView, true);
+                    gtkPainter->setWidgetFocus(gtkTreeView, true);
                 }
                 bool isEnabled = (widget ? widget->isEnabled() : (vopt->state & QStyle::State_Enabled));
                 gtkPainter->paintFlatBox(gtkTreeView, detail, option->rect,
                                          option->state & State_Selected ? GTK_STATE_SELECTED :
                                          isEnabled ? GTK_STATE_NORMAL : GTK_STATE_INSENSITIVE,
-                                         GTK_SHADOW_OUT, gtk_widget_get_style(gtkTreeView), key);
+                                         GTK_SHADOW_OUT, gtk_widget_get_style(gtkTreeView),
+                                         QGtkPainterExtra(isActive ? QGtkPainterExtra::Active : 0));
                 if (isActive )
-                    QGtkStylePrivate::QGtkStylePrivate::gtkWidgetSetFocus(gtkTreeView, false);
+                    gtkPainter->setWidgetFocus(gtkTreeView, false);
             }
         }
         break;
     case PE_IndicatorToolBarSeparator:
         {
             const int margin = 6;
-            GtkWidget *gtkSeparator = d->gtkWidget("GtkToolbar.GtkSeparatorToolItem");
+            GtkWidget *gtkSeparator = d->gtkWidget(QGtkWidgetId::ToolbarSeparatorToolItem);
             if (option->state & State_Horizontal) {
                 const int offset = option->rect.width()/2;
                 QRect rect = option->rect.adjusted(offset, margin, 0, -margin);
@@ -1082,9 +1189,8 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
        break;
 
     case PE_IndicatorToolBarHandle: {
-        GtkWidget *gtkToolbar = d->gtkWidget("GtkToolbar");
-        GtkShadowType shadow_type;
-        gtk_widget_style_get(gtkToolbar, "shadow-type", &shadow_type, nullptr);
+        GtkWidget *gtkToolbar = d->gtkWidget(QGtkWidgetId::Toolbar);
+        const GtkShadowType shadow_type = d->styleProperties(QGtkWidgetId::Toolbar).shadowType;
         //Note when the toolbar is horizontal, the handle is vertical
         painter->setClipRect(option->rect);
         gtkPainter->paintHandle(gtkToolbar, "toolbar", option->rect.adjusted(-1, -1 ,0 ,1),
@@ -1130,7 +1236,7 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
         GtkStateType state = qt_gtk_state(option);
 
         QColor arrowColor = option->palette.buttonText().color();
-        GtkWidget *gtkArrow = d->gtkWidget("GtkArrow");
+        GtkWidget *gtkArrow = d->gtkWidget(QGtkWidgetId::Arrow);
         GdkColor color = fromQColor(arrowColor);
         gtk_widget_modify_fg (gtkArrow, state, &color);
         gtkPainter->paintArrow(gtkArrow, "button", arrowRect,
@@ -1146,9 +1252,8 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
         break;
 
     case PE_PanelMenu: {
-            GtkWidget *gtkMenu = d->gtkWidget("GtkMenu");
-            gtkPainter->setAlphaSupport(false); // Note, alpha disabled for performance reasons
-            gtkPainter->paintBox(gtkMenu, "menu", option->rect, GTK_STATE_NORMAL, GTK_SHADOW_OUT, gtk_widget_get_style(gtkMenu), QString());
+            GtkWidget *gtkMenu = d->gtkWidget(QGtkWidgetId::Menu);
+            gtkPainter->paintBox(gtkMenu, "menu", option->rect, GTK_STATE_NORMAL, GTK_SHADOW_OUT, gtk_widget_get_style(gtkMenu));
         }
         break;
 
@@ -1158,7 +1263,7 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
 
         // This is only used by floating tool bars
         if (qobject_cast<const QToolBar *>(widget)) {
-            GtkWidget *gtkMenubar = d->gtkWidget("GtkMenuBar");
+            GtkWidget *gtkMenubar = d->gtkWidget(QGtkWidgetId::MenuBar);
             gtkPainter->paintBox(gtkMenubar, "toolbar", option->rect,
                                  GTK_STATE_NORMAL, GTK_SHADOW_OUT, style);
             gtkPainter->paintBox(gtkMenubar, "menu", option->rect,
@@ -1167,41 +1272,38 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
         break;
 
     case PE_FrameLineEdit: {
-        GtkWidget *gtkEntry = d->gtkWidget("GtkEntry");
+        GtkWidget *gtkEntry = d->gtkWidget(QGtkWidgetId::Entry);
 
 
-        gboolean interior_focus;
-        gint focus_line_width;
+        const QGtkStyleProperties &properties = d->styleProperties(QGtkWidgetId::Entry);
+        const gboolean interior_focus = properties.interiorFocus;
+        const gint focus_line_width = properties.focusLineWidth;
         QRect rect = option->rect;
-        gtk_widget_style_get(gtkEntry,
-                               "interior-focus", &interior_focus,
-                               "focus-line-width", &focus_line_width, nullptr);
-
-        // See https://bugzilla.mozilla.org/show_bug.cgi?id=405421 for info about this hack
-        g_object_set_data(G_OBJECT(gtkEntry), "transparent-bg-hint", GINT_TO_POINTER(true));
 
         if (!interior_focus && option->state & State_HasFocus)
             rect.adjust(focus_line_width, focus_line_width, -focus_line_width, -focus_line_width);
 
         if (option->state & State_HasFocus)
-            QGtkStylePrivate::gtkWidgetSetFocus(gtkEntry, true);
+            gtkPainter->setWidgetFocus(gtkEntry, true);
         gtkPainter->paintShadow(gtkEntry, "entry", rect, option->state & State_Enabled ?
                                 GTK_STATE_NORMAL : GTK_STATE_INSENSITIVE,
                                 GTK_SHADOW_IN, gtk_widget_get_style(gtkEntry),
-                                option->state & State_HasFocus ? QLS("focus") : QString());
-        if (!interior_focus && option->state & State_HasFocus)
+                                QGtkPainterExtra(option->state & State_HasFocus ? QGtkPainterExtra::Focus : 0));
+        if (!interior_focus && option->state & State_HasFocus) {
+            static const quint32 shadowInId = QGtkPainter::detailId("GtkEntryShadowIn");
             gtkPainter->paintShadow(gtkEntry, "entry", option->rect, option->state & State_Enabled ?
                                     GTK_STATE_ACTIVE : GTK_STATE_INSENSITIVE,
-                                    GTK_SHADOW_IN, gtk_widget_get_style(gtkEntry), QLS("GtkEntryShadowIn"));
+                                    GTK_SHADOW_IN, gtk_widget_get_style(gtkEntry), QGtkPainterExtra(0, 0, 0, shadowInId));
+        }
 
         if (option->state & State_HasFocus)
-            QGtkStylePrivate::gtkWidgetSetFocus(gtkEntry, false);
+            gtkPainter->setWidgetFocus(gtkEntry, false);
     }
     break;
 
     case PE_PanelLineEdit:
         if (const QStyleOptionFrame *panel = qstyleoption_cast<const QStyleOptionFrame *>(option)) {
-            GtkWidget *gtkEntry = d->gtkWidget("GtkEntry");
+            GtkWidget *gtkEntry = d->gtkWidget(QGtkWidgetId::Entry);
             if (panel->lineWidth > 0)
                 proxy()->drawPrimitive(PE_FrameLineEdit, option, painter, widget);
             quint64 resolve_mask = option->palette.resolveMask();
@@ -1220,13 +1322,12 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
 
     case PE_FrameTabWidget:
         if (const QStyleOptionTabWidgetFrame *frame = qstyleoption_cast<const QStyleOptionTabWidgetFrame*>(option)) {
-            GtkWidget *gtkNotebook = d->gtkWidget("GtkNotebook");
+            GtkWidget *gtkNotebook = d->gtkWidget(QGtkWidgetId::Notebook);
             style = gtk_widget_get_style(gtkNotebook);
-            gtkPainter->setAlphaSupport(false);
             GtkShadowType shadow = GTK_SHADOW_OUT;
             GtkStateType state = GTK_STATE_NORMAL; // Only state supported by gtknotebook
             bool reverse = (option->direction == Qt::RightToLeft);
-            gtk_widget_set_direction(gtkNotebook, reverse ? GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
+            gtkPainter->setWidgetDirection(gtkNotebook, reverse ? GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
             if (const QStyleOptionTabWidgetFrame *tabframe = qstyleoption_cast<const QStyleOptionTabWidgetFrame*>(option)) {
                 GtkPositionType frameType = GTK_POS_TOP;
                 QTabBar::Shape shape = frame->shape;
@@ -1268,32 +1369,29 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
         GtkStateType state = qt_gtk_state(option);
         if (option->state & State_On || option->state & State_Sunken)
             state = GTK_STATE_ACTIVE;
-        GtkWidget *gtkButton = isTool ? d->gtkWidget("GtkToolButton.GtkButton") : d->gtkWidget("GtkButton");
-        gint focusWidth, focusPad;
-        gboolean interiorFocus = false;
-        gtk_widget_style_get (gtkButton,
-                                "focus-line-width", &focusWidth,
-                                "focus-padding", &focusPad,
-                                "interior-focus", &interiorFocus, nullptr);
+        const QGtkWidgetId buttonId = isTool ? QGtkWidgetId::ToolButtonButton : QGtkWidgetId::Button;
+        GtkWidget *gtkButton = d->gtkWidget(buttonId);
+        const QGtkStyleProperties &properties = d->styleProperties(buttonId);
+        const gint focusWidth = properties.focusLineWidth;
+        const gboolean interiorFocus = properties.interiorFocus;
 
         style = gtk_widget_get_style(gtkButton);
 
         QRect buttonRect = option->rect;
 
-        QString key;
+        QGtkPainterExtra extra = QGtkPainterExtra();
         if (isDefault) {
-            key += QLS("def");
-            gtk_widget_set_can_default(gtkButton, true);
-            gtk_window_set_default((GtkWindow*)gtk_widget_get_toplevel(gtkButton), gtkButton);
+            extra.flags |= QGtkPainterExtra::Default;
+            gtkPainter->setDefaultWidget(gtkButton);
             gtkPainter->paintBox(gtkButton, "buttondefault", buttonRect, state, GTK_SHADOW_IN,
-                                 style, isDefault ? QLS("d") : QString());
+                                 style, QGtkPainterExtra(QGtkPainterExtra::Default));
         }
 
         bool hasFocus = option->state & State_HasFocus;
 
         if (hasFocus) {
-            key += QLS("def");
-            QGtkStylePrivate::gtkWidgetSetFocus(gtkButton, true);
+            extra.flags |= QGtkPainterExtra::Focus;
+            gtkPainter->setWidgetFocus(gtkButton, true);
         }
 
         if (!interiorFocus)
@@ -1303,11 +1401,11 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
                                GTK_SHADOW_IN : GTK_SHADOW_OUT;
 
         gtkPainter->paintBox(gtkButton, "button", buttonRect, state, shadow,
-                             style, key);
+                             style, extra);
         if (isDefault)
-            gtk_window_set_default((GtkWindow*)gtk_widget_get_toplevel(gtkButton), nullptr);
+            gtkPainter->setDefaultWidget(nullptr);
         if (hasFocus)
-            QGtkStylePrivate::gtkWidgetSetFocus(gtkButton, false);
+            gtkPainter->setWidgetFocus(gtkButton, false);
     }
     break;
 
@@ -1325,22 +1423,20 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
         else
             shadow = GTK_SHADOW_OUT;
 
-        GtkWidget *gtkRadioButton = d->gtkWidget("GtkRadioButton");
-        gint spacing;
-        gtk_widget_style_get(gtkRadioButton, "indicator-spacing", &spacing, nullptr);
+        GtkWidget *gtkRadioButton = d->gtkWidget(QGtkWidgetId::RadioButton);
+        const gint spacing = d->styleProperties(QGtkWidgetId::RadioButton).indicatorSpacing;
         QRect buttonRect = option->rect.adjusted(spacing, spacing, -spacing, -spacing);
         gtkPainter->setClipRect(option->rect);
         // ### Note: Ubuntulooks breaks when the proper widget is passed
         //           Murrine engine requires a widget not to get RGBA check - warnings
-        GtkWidget *gtkCheckButton = d->gtkWidget("GtkCheckButton");
-        QString key(QLS("radiobutton"));
-        if (option->state & State_HasFocus) { // Themes such as Nodoka check this flag
-            key += QLatin1Char('f');
-            QGtkStylePrivate::gtkWidgetSetFocus(gtkCheckButton, true);
-        }
-        gtkPainter->paintOption(gtkCheckButton , buttonRect, state, shadow, gtk_widget_get_style(gtkRadioButton), key);
+        GtkWidget *gtkCheckButton = d->gtkWidget(QGtkWidgetId::CheckButton);
+        if (option->state & State_HasFocus) // Themes such as Nodoka check this flag
+            gtkPainter->setWidgetFocus(gtkCheckButton, true);
+        // The detail of a focused indicator has always had an 'f' appended
+        gtkPainter->paintOption(gtkCheckButton , buttonRect, state, shadow, gtk_widget_get_style(gtkRadioButton),
+                                option->state & State_HasFocus ? "radiobuttonf" : "radiobutton");
         if (option->state & State_HasFocus)
-            QGtkStylePrivate::gtkWidgetSetFocus(gtkCheckButton, false);
+            gtkPainter->setWidgetFocus(gtkCheckButton, false);
     }
     break;
 
@@ -1360,24 +1456,22 @@ void QGtkStyle::drawPrimitive(PrimitiveElement element,
 
         int spacing;
 
-        GtkWidget *gtkCheckButton = d->gtkWidget("GtkCheckButton");
-        QString key(QLS("checkbutton"));
-        if (option->state & State_HasFocus) { // Themes such as Nodoka checks this flag
-            key += QLatin1Char('f');
-            QGtkStylePrivate::gtkWidgetSetFocus(gtkCheckButton, true);
-        }
+        GtkWidget *gtkCheckButton = d->gtkWidget(QGtkWidgetId::CheckButton);
+        if (option->state & State_HasFocus) // Themes such as Nodoka checks this flag
+            gtkPainter->setWidgetFocus(gtkCheckButton, true);
 
         // Some styles such as aero-clone assume they can paint in the spacing area
         gtkPainter->setClipRect(option->rect);
 
-        gtk_widget_style_get(gtkCheckButton, "indicator-spacing", &spacing, nullptr);
+        spacing = d->styleProperties(QGtkWidgetId::CheckButton).indicatorSpacing;
 
         QRect checkRect = option->rect.adjusted(spacing, spacing, -spacing, -spacing);
 
+        // The detail of a focused indicator has always had an 'f' appended
         gtkPainter->paintCheckbox(gtkCheckButton, checkRect, state, shadow, gtk_widget_get_style(gtkCheckButton),
-                                  key);
+                                  option->state & State_HasFocus ? "checkbuttonf" : "checkbutton");
         if (option->state & State_HasFocus)
-            QGtkStylePrivate::gtkWidgetSetFocus(gtkCheckButton, false);
+            gtkPainter->setWidgetFocus(gtkCheckButton, false);
 
     }
     break;
@@ -1756,7 +1850,7 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
 
             if ((groupBox->subControls & QStyle::SC_GroupBoxLabel) && !groupBox->text.isEmpty()) {
                 // Draw prelight background
-                GtkWidget *gtkCheckButton = d->gtkWidget("GtkCheckButton");
+                GtkWidget *gtkCheckButton = d->gtkWidget(QGtkWidgetId::CheckButton);
 
                 if (option->state & State_MouseOver) {
                     QRect bgRect = textRect | checkBoxRect;
@@ -1806,7 +1900,7 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
         // and http://live.gnome.org/GnomeArt/Tutorials/GtkThemes/GtkComboBoxEntry
         if (const QStyleOptionComboBox *comboBox = qstyleoption_cast<const QStyleOptionComboBox *>(option)) {
             bool sunken = comboBox->state & State_On; // play dead, if combobox has no items
-            BEGIN_STYLE_PIXMAPCACHE(QString::fromLatin1("cb-%0-%1").arg(sunken).arg(comboBox->editable));
+            BEGIN_GTK_STYLE_PIXMAPCACHE(QString::fromLatin1("cb-%0-%1").arg(sunken).arg(comboBox->editable));
             gtkPainter->reset(p);
             gtkPainter->setUsePixmapCache(false); // cached externally
 
@@ -1824,27 +1918,27 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
 
             GtkShadowType shadow = (option->state & State_Sunken || option->state & State_On ) ?
                                    GTK_SHADOW_IN : GTK_SHADOW_OUT;
-            const QHashableLatin1Literal comboBoxPath = comboBox->editable ? QHashableLatin1Literal("GtkComboBoxEntry") : QHashableLatin1Literal("GtkComboBox");
+            const QGtkWidgetId comboBoxId = comboBox->editable ? QGtkWidgetId::ComboBoxEntry : QGtkWidgetId::ComboBox;
 
             // We use the gtk widget to position arrows and separators for us
-            GtkWidget *gtkCombo = d->gtkWidget(comboBoxPath);
+            GtkWidget *gtkCombo = d->gtkWidget(comboBoxId);
             GtkAllocation geometry = {0, 0, option->rect.width(), option->rect.height()};
             gtk_widget_set_direction(gtkCombo, reverse ? GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
             gtk_widget_size_allocate(gtkCombo, &geometry);
 
-            QHashableLatin1Literal buttonPath = comboBox->editable ? QHashableLatin1Literal("GtkComboBoxEntry.GtkToggleButton")
-                                : QHashableLatin1Literal("GtkComboBox.GtkToggleButton");
-            GtkWidget *gtkToggleButton = d->gtkWidget(buttonPath);
-            gtk_widget_set_direction(gtkToggleButton, reverse ? GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
+            const QGtkWidgetId buttonId = comboBox->editable ? QGtkWidgetId::ComboBoxEntryToggleButton
+                                : QGtkWidgetId::ComboBoxToggleButton;
+            GtkWidget *gtkToggleButton = d->gtkWidget(buttonId);
+            gtkPainter->setWidgetDirection(gtkToggleButton, reverse ? GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
             if (gtkToggleButton && (appears_as_list || comboBox->editable)) {
                 if (focus)
-                    QGtkStylePrivate::gtkWidgetSetFocus(gtkToggleButton, true);
+                    gtkPainter->setWidgetFocus(gtkToggleButton, true);
                 // Draw the combo box as a line edit with a button next to it
                 if (comboBox->editable || appears_as_list) {
                     GtkStateType frameState = (state == GTK_STATE_PRELIGHT) ? GTK_STATE_NORMAL : state;
-                    QHashableLatin1Literal entryPath = comboBox->editable ? QHashableLatin1Literal("GtkComboBoxEntry.GtkEntry") : QHashableLatin1Literal("GtkComboBox.GtkFrame");
-                    GtkWidget *gtkEntry = d->gtkWidget(entryPath);
-                    gtk_widget_set_direction(gtkEntry, reverse ? GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
+                    const QGtkWidgetId entryId = comboBox->editable ? QGtkWidgetId::ComboBoxEntryEntry : QGtkWidgetId::ComboBoxFrame;
+                    GtkWidget *gtkEntry = d->gtkWidget(entryId);
+                    gtkPainter->setWidgetDirection(gtkEntry, reverse ? GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
                     QRect frameRect = option->rect;
 
                     if (reverse)
@@ -1860,7 +1954,7 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                                                            -gtkEntryStyle->xthickness, -gtkEntryStyle->ythickness);
                     // Required for inner blue highlight with clearlooks
                     if (focus)
-                        QGtkStylePrivate::gtkWidgetSetFocus(gtkEntry, true);
+                        gtkPainter->setWidgetFocus(gtkEntry, true);
 
                     if (widget && widget->testAttribute(Qt::WA_SetPalette) &&
                         resolve_mask & (1 << QPalette::Base)) // Palette overridden by user
@@ -1868,15 +1962,17 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                     else {
                         gtkPainter->paintFlatBox(gtkEntry, "entry_bg", contentRect,
                                                  option->state & State_Enabled ? GTK_STATE_NORMAL : GTK_STATE_INSENSITIVE,
-                                                 GTK_SHADOW_NONE, gtkEntryStyle, entryPath.toString() + QString::number(focus));
+                                                 GTK_SHADOW_NONE, gtkEntryStyle,
+                                                 QGtkPainterExtra(focus ? QGtkPainterExtra::Focus : 0, int(entryId)));
                     }
 
                     gtkPainter->paintShadow(gtkEntry, comboBox->editable ? "entry" : "frame", frameRect, frameState,
-                                            GTK_SHADOW_IN, gtkEntryStyle, entryPath.toString() +
-                                            QString::number(focus) + QString::number(comboBox->editable) +
-                                            QString::number(option->direction));
+                                            GTK_SHADOW_IN, gtkEntryStyle,
+                                            QGtkPainterExtra((focus ? QGtkPainterExtra::Focus : 0) |
+                                                             (comboBox->editable ? QGtkPainterExtra::Editable : 0) |
+                                                             (reverse ? QGtkPainterExtra::RightToLeft : 0), int(entryId)));
                     if (focus)
-                        QGtkStylePrivate::gtkWidgetSetFocus(gtkEntry, false);
+                        gtkPainter->setWidgetFocus(gtkEntry, false);
                 }
 
                 GtkStateType buttonState = GTK_STATE_NORMAL;
@@ -1890,42 +1986,42 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
 
                 Q_ASSERT(gtkToggleButton);
                 gtkPainter->paintBox(gtkToggleButton, "button", arrowButtonRect, buttonState,
-                                     shadow, gtk_widget_get_style(gtkToggleButton), buttonPath.toString() +
-                                     QString::number(focus) + QString::number(option->direction));
+                                     shadow, gtk_widget_get_style(gtkToggleButton),
+                                     QGtkPainterExtra((focus ? QGtkPainterExtra::Focus : 0) |
+                                                      (reverse ? QGtkPainterExtra::RightToLeft : 0), int(buttonId)));
                 if (focus)
-                    QGtkStylePrivate::gtkWidgetSetFocus(gtkToggleButton, false);
+                    gtkPainter->setWidgetFocus(gtkToggleButton, false);
             } else {
                 // Draw combo box as a button
                 QRect buttonRect = option->rect;
                 GtkStyle *gtkToggleButtonStyle = gtk_widget_get_style(gtkToggleButton);
 
                 if (focus) // Clearlooks actually check the widget for the default state
-                    QGtkStylePrivate::gtkWidgetSetFocus(gtkToggleButton, true);
+                    gtkPainter->setWidgetFocus(gtkToggleButton, true);
                 gtkPainter->paintBox(gtkToggleButton, "button",
                                      buttonRect, state,
                                      shadow, gtkToggleButtonStyle,
-                                     buttonPath.toString() + QString::number(focus));
+                                     QGtkPainterExtra(focus ? QGtkPainterExtra::Focus : 0, int(buttonId)));
                 if (focus)
-                    QGtkStylePrivate::gtkWidgetSetFocus(gtkToggleButton, false);
+                    gtkPainter->setWidgetFocus(gtkToggleButton, false);
 
 
                 // Draw the separator between label and arrows
-                QHashableLatin1Literal vSeparatorPath = comboBox->editable
-                    ? QHashableLatin1Literal("GtkComboBoxEntry.GtkToggleButton.GtkHBox.GtkVSeparator")
-                    : QHashableLatin1Literal("GtkComboBox.GtkToggleButton.GtkHBox.GtkVSeparator");
+                const QGtkWidgetId vSeparatorId = comboBox->editable
+                    ? QGtkWidgetId::ComboBoxEntryToggleButtonHBoxVSeparator
+                    : QGtkWidgetId::ComboBoxToggleButtonHBoxVSeparator;
 
-                if (GtkWidget *gtkVSeparator = d->gtkWidget(vSeparatorPath)) {
+                if (GtkWidget *gtkVSeparator = d->gtkWidget(vSeparatorId)) {
                     GtkAllocation allocation;
                     gtk_widget_get_allocation(gtkVSeparator, &allocation);
                     QRect vLineRect(allocation.x, allocation.y, allocation.width, allocation.height);
 
                     gtkPainter->paintVline(gtkVSeparator, "vseparator",
                                            vLineRect, state, gtk_widget_get_style(gtkVSeparator),
-                                           0, vLineRect.height(), 0, vSeparatorPath.toString());
+                                           0, vLineRect.height(), 0, QGtkPainterExtra(0, int(vSeparatorId)));
 
 
-                    gint interiorFocus = true;
-                    gtk_widget_style_get(gtkToggleButton, "interior-focus", &interiorFocus, nullptr);
+                    const gboolean interiorFocus = d->styleProperties(buttonId).interiorFocus;
                     int xt = interiorFocus ? gtkToggleButtonStyle->xthickness : 0;
                     int yt = interiorFocus ? gtkToggleButtonStyle->ythickness : 0;
                     if (focus && ((option->state & State_KeyboardFocusChange) || styleHint(SH_UnderlineShortcut, option, widget)))
@@ -1946,27 +2042,27 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                 else
                     state = GTK_STATE_NORMAL;
 
-                QHashableLatin1Literal arrowPath("");
+                QGtkWidgetId arrowId;
                 if (comboBox->editable) {
                     if (appears_as_list)
-                        arrowPath = QHashableLatin1Literal("GtkComboBoxEntry.GtkToggleButton.GtkArrow");
+                        arrowId = QGtkWidgetId::ComboBoxEntryToggleButtonArrow;
                     else
-                        arrowPath = QHashableLatin1Literal("GtkComboBoxEntry.GtkToggleButton.GtkHBox.GtkArrow");
+                        arrowId = QGtkWidgetId::ComboBoxEntryToggleButtonHBoxArrow;
                 } else {
                     if (appears_as_list)
-                        arrowPath = QHashableLatin1Literal("GtkComboBox.GtkToggleButton.GtkArrow");
+                        arrowId = QGtkWidgetId::ComboBoxToggleButtonArrow;
                     else
-                        arrowPath = QHashableLatin1Literal("GtkComboBox.GtkToggleButton.GtkHBox.GtkArrow");
+                        arrowId = QGtkWidgetId::ComboBoxToggleButtonHBoxArrow;
                 }
 
-                GtkWidget *gtkArrow = d->gtkWidget(arrowPath);
+                GtkWidget *gtkArrow = d->gtkWidget(arrowId);
                 gfloat scale = 0.7;
                 gint minSize = 15;
                 QRect arrowWidgetRect;
 
-                if (gtkArrow && !gtk_check_version(2, 12, 0)) {
-                    gtk_widget_style_get(gtkArrow, "arrow-scaling", &scale, nullptr);
-                    gtk_widget_style_get(gtkCombo, "arrow-size", &minSize, nullptr);
+                if (gtkArrow) {
+                    scale = d->styleProperties(arrowId).arrowScaling;
+                    minSize = d->styleProperties(comboBoxId).arrowSize;
                 }
                 if (gtkArrow) {
                     GtkAllocation allocation;
@@ -1984,14 +2080,9 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                 arrowRect.moveCenter(arrowWidgetRect.center());
 
                 if (sunken) {
-                    int xoff, yoff;
-                    const QHashableLatin1Literal toggleButtonPath = comboBox->editable
-                            ? QHashableLatin1Literal("GtkComboBoxEntry.GtkToggleButton")
-                            : QHashableLatin1Literal("GtkComboBox.GtkToggleButton");
-
-                    GtkWidget *gtkButton = d->gtkWidget(toggleButtonPath);
-                    gtk_widget_style_get(gtkButton, "child-displacement-x", &xoff, nullptr);
-                    gtk_widget_style_get(gtkButton, "child-displacement-y", &yoff, nullptr);
+                    const QGtkStyleProperties &properties = d->styleProperties(buttonId);
+                    const int xoff = properties.childDisplacementX;
+                    const int yoff = properties.childDisplacementY;
                     arrowRect = arrowRect.adjusted(xoff, yoff, xoff, yoff);
                 }
 
@@ -2001,10 +2092,10 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                     gtkPainter->setClipRect(option->rect);
                     gtkPainter->paintArrow(gtkArrow, "arrow", arrowRect,
                                            GTK_ARROW_DOWN, state, GTK_SHADOW_NONE, true,
-                                           style, arrowPath.toString() + QString::number(option->direction));
+                                           style, QGtkPainterExtra(reverse ? QGtkPainterExtra::RightToLeft : 0, int(arrowId)));
                 }
             }
-            END_STYLE_PIXMAPCACHE;
+            END_GTK_STYLE_PIXMAPCACHE;
         }
         break;
 #endif // QT_NO_COMBOBOX
@@ -2060,7 +2151,7 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
 
             QStyleOptionToolButton label = *toolbutton;
             label.state = bflags;
-            GtkWidget *gtkButton = d->gtkWidget("GtkToolButton.GtkButton");
+            GtkWidget *gtkButton = d->gtkWidget(QGtkWidgetId::ToolButtonButton);
             QPalette pal = toolbutton->palette;
             if (option->state & State_Enabled &&
                 option->state & State_MouseOver && !(widget && widget->testAttribute(Qt::WA_SetPalette))) {
@@ -2095,8 +2186,8 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
 
     case CC_ScrollBar:
         if (const QStyleOptionSlider *scrollBar = qstyleoption_cast<const QStyleOptionSlider *>(option)) {
-            GtkWidget *gtkHScrollBar = d->gtkWidget("GtkHScrollbar");
-            GtkWidget *gtkVScrollBar = d->gtkWidget("GtkVScrollbar");
+            GtkWidget *gtkHScrollBar = d->gtkWidget(QGtkWidgetId::HScrollbar);
+            GtkWidget *gtkVScrollBar = d->gtkWidget(QGtkWidgetId::VScrollbar);
 
             // Fill background in case the scrollbar is partially transparent
             painter->fillRect(option->rect, option->palette.window());
@@ -2109,19 +2200,13 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
             bool horizontal = scrollBar->orientation == Qt::Horizontal;
             GtkWidget * scrollbarWidget = horizontal ? gtkHScrollBar : gtkVScrollBar;
             style = gtk_widget_get_style(scrollbarWidget);
-            gboolean trough_under_steppers = true;
-            gboolean trough_side_details = false;
-            gboolean activate_slider = true;
-            gboolean stepper_size = 14;
-            gint trough_border = 1;
-            if (!gtk_check_version(2, 10, 0)) {
-                gtk_widget_style_get((GtkWidget*)(scrollbarWidget),
-                                           "trough-border",         &trough_border,
-                                           "trough-side-details",   &trough_side_details,
-                                           "trough-under-steppers", &trough_under_steppers,
-                                           /*"activate-slider",       &activate_slider,*/ //deprecated
-                                           "stepper-size",          &stepper_size, nullptr);
-            }
+            const QGtkStyleProperties &properties = d->styleProperties(horizontal ? QGtkWidgetId::HScrollbar
+                                                                                  : QGtkWidgetId::VScrollbar);
+            const gboolean trough_under_steppers = properties.troughUnderSteppers;
+            const gboolean trough_side_details = properties.troughSideDetails;
+            const gboolean activate_slider = true; // "activate-slider" is deprecated
+            const gint stepper_size = properties.stepperSize;
+            const gint trough_border = properties.troughBorder;
             if (trough_under_steppers) {
                 scrollBarAddLine.adjust(trough_border, trough_border, -trough_border, -trough_border);
                 scrollBarSubLine.adjust(trough_border, trough_border, -trough_border, -trough_border);
@@ -2143,16 +2228,7 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
 
 
             GtkRange *range = (GtkRange*)(horizontal ? gtkHScrollBar : gtkVScrollBar);
-            GtkAdjustment *adjustment = nullptr;
-
-            adjustment = gtk_range_get_adjustment(range);
-
-            if (adjustment) {
-                gtk_adjustment_configure(adjustment, fakePos, 0, maximum, 0, 0, 0);
-            } else {
-                adjustment = (GtkAdjustment*)gtk_adjustment_new(fakePos, 0, maximum, 0, 0, 0);
-                gtk_range_set_adjustment(range, adjustment);
-            }
+            gtkPainter->setRangeAdjustment(range, fakePos, 0, maximum, 0, 0, 0);
 
             if (scrollBar->subControls & SC_ScrollBarGroove) {
                 GtkStateType state = GTK_STATE_ACTIVE;
@@ -2188,7 +2264,7 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                 }
 
                 gtkPainter->paintSlider(scrollbarWidget, "slider", scrollBarSlider, state, shadow, style,
-                                        horizontal ? GTK_ORIENTATION_HORIZONTAL : GTK_ORIENTATION_VERTICAL, QString(QLS("%0%1")).arg(fakePos).arg(maximum));
+                                        horizontal ? GTK_ORIENTATION_HORIZONTAL : GTK_ORIENTATION_VERTICAL, QGtkPainterExtra(0, fakePos, maximum));
             }
 
             if (scrollBar->subControls & SC_ScrollBarAddLine) {
@@ -2214,9 +2290,10 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                 } else if (option->state & State_MouseOver && (scrollBar->activeSubControls & SC_ScrollBarAddLine))
                     state = GTK_STATE_PRELIGHT;
 
+                static const quint32 addId = QGtkPainter::detailId("add");
                 gtkPainter->paintBox(scrollbarWidget,
                                      horizontal ? "hscrollbar" : "vscrollbar", scrollBarAddLine,
-                                     state, shadow, style, QLS("add"));
+                                     state, shadow, style, QGtkPainterExtra(0, 0, 0, addId));
 
                 gtkPainter->paintArrow(scrollbarWidget, horizontal ? "hscrollbar" : "vscrollbar", scrollBarAddLine.adjusted(4, 4, -4, -4),
                                        horizontal ? (reverse ? GTK_ARROW_LEFT : GTK_ARROW_RIGHT) :
@@ -2246,8 +2323,9 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                 } else if (option->state & State_MouseOver && (scrollBar->activeSubControls & SC_ScrollBarSubLine))
                     state = GTK_STATE_PRELIGHT;
 
+                static const quint32 subId = QGtkPainter::detailId("sub");
                 gtkPainter->paintBox(scrollbarWidget, horizontal ? "hscrollbar" : "vscrollbar", scrollBarSubLine,
-                                     state, shadow, style, QLS("sub"));
+                                     state, shadow, style, QGtkPainterExtra(0, 0, 0, subId));
 
                 gtkPainter->paintArrow(scrollbarWidget, horizontal ? "hscrollbar" : "vscrollbar", scrollBarSubLine.adjusted(4, 4, -4, -4),
                                        horizontal ? (reverse ? GTK_ARROW_RIGHT : GTK_ARROW_LEFT) :
@@ -2263,8 +2341,8 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
         if (const QStyleOptionSpinBox *spinBox = qstyleoption_cast<const QStyleOptionSpinBox *>(option)) {
 
             GtkWidget *gtkSpinButton = spinBox->buttonSymbols == QAbstractSpinBox::NoButtons
-                        ? d->gtkWidget("GtkEntry")
-                        : d->gtkWidget("GtkSpinButton");
+                        ? d->gtkWidget(QGtkWidgetId::Entry)
+                        : d->gtkWidget(QGtkWidgetId::SpinButton);
             bool isEnabled = (spinBox->state & State_Enabled);
             bool hover = isEnabled && (spinBox->state & State_MouseOver);
             bool sunken = (spinBox->state & State_Sunken);
@@ -2314,12 +2392,10 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                 style = gtk_widget_get_style(gtkSpinButton);
 
 
-                QString key;
+                const QGtkPainterExtra extra(option->state & State_HasFocus ? QGtkPainterExtra::Focus : 0);
 
-                if (option->state & State_HasFocus) {
-                    key += QLatin1Char('f');
-                    QGtkStylePrivate::gtkWidgetSetFocus(gtkSpinButton, true);
-                }
+                if (option->state & State_HasFocus)
+                    gtkPainter->setWidgetFocus(gtkSpinButton, true);
 
                 quint64 resolve_mask = option->palette.resolveMask();
 
@@ -2329,34 +2405,34 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                     gtkPainter->paintFlatBox(gtkSpinButton, "entry_bg", editArea.adjusted(style->xthickness, style->ythickness,
                                              -style->xthickness, -style->ythickness),
                                              option->state & State_Enabled ?
-                                             GTK_STATE_NORMAL : GTK_STATE_INSENSITIVE, GTK_SHADOW_NONE, style, key);
+                                             GTK_STATE_NORMAL : GTK_STATE_INSENSITIVE, GTK_SHADOW_NONE, style, extra);
 
-                gtkPainter->paintShadow(gtkSpinButton, "entry", editArea, state, GTK_SHADOW_IN, gtk_widget_get_style(gtkSpinButton), key);
+                gtkPainter->paintShadow(gtkSpinButton, "entry", editArea, state, GTK_SHADOW_IN, gtk_widget_get_style(gtkSpinButton), extra);
                 if (spinBox->buttonSymbols != QAbstractSpinBox::NoButtons) {
-                    gtkPainter->paintBox(gtkSpinButton, "spinbutton", buttonRect, state, GTK_SHADOW_IN, style, key);
+                    gtkPainter->paintBox(gtkSpinButton, "spinbutton", buttonRect, state, GTK_SHADOW_IN, style, extra);
 
                     upRect.setSize(downRect.size());
                     if (!(option->state & State_Enabled))
-                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_up", upRect, GTK_STATE_INSENSITIVE, GTK_SHADOW_IN, style, key);
+                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_up", upRect, GTK_STATE_INSENSITIVE, GTK_SHADOW_IN, style, extra);
                     else if (upIsActive && sunken)
-                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_up", upRect, GTK_STATE_ACTIVE, GTK_SHADOW_IN, style, key);
+                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_up", upRect, GTK_STATE_ACTIVE, GTK_SHADOW_IN, style, extra);
                     else if (upIsActive && hover)
-                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_up", upRect, GTK_STATE_PRELIGHT, GTK_SHADOW_OUT, style, key);
+                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_up", upRect, GTK_STATE_PRELIGHT, GTK_SHADOW_OUT, style, extra);
                     else
-                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_up", upRect, GTK_STATE_NORMAL, GTK_SHADOW_OUT, style, key);
+                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_up", upRect, GTK_STATE_NORMAL, GTK_SHADOW_OUT, style, extra);
 
                     if (!(option->state & State_Enabled))
-                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_down", downRect, GTK_STATE_INSENSITIVE, GTK_SHADOW_IN, style, key);
+                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_down", downRect, GTK_STATE_INSENSITIVE, GTK_SHADOW_IN, style, extra);
                     else if (downIsActive && sunken)
-                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_down", downRect, GTK_STATE_ACTIVE, GTK_SHADOW_IN, style, key);
+                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_down", downRect, GTK_STATE_ACTIVE, GTK_SHADOW_IN, style, extra);
                     else if (downIsActive && hover)
-                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_down", downRect, GTK_STATE_PRELIGHT, GTK_SHADOW_OUT, style, key);
+                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_down", downRect, GTK_STATE_PRELIGHT, GTK_SHADOW_OUT, style, extra);
                     else
-                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_down", downRect, GTK_STATE_NORMAL, GTK_SHADOW_OUT, style, key);
-
-                    if (option->state & State_HasFocus)
-                        QGtkStylePrivate::gtkWidgetSetFocus(gtkSpinButton, false);
+                        gtkPainter->paintBox(gtkSpinButton, "spinbutton_down", downRect, GTK_STATE_NORMAL, GTK_SHADOW_OUT, style, extra);
                 }
+
+                if (option->state & State_HasFocus)
+                    gtkPainter->setWidgetFocus(gtkSpinButton, false);
             }
 
             if (spinBox->buttonSymbols == QAbstractSpinBox::PlusMinus) {
@@ -2414,8 +2490,8 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
 
     case CC_Slider:
         if (const QStyleOptionSlider *slider = qstyleoption_cast<const QStyleOptionSlider *>(option)) {
-            GtkWidget *hScaleWidget = d->gtkWidget("GtkHScale");
-            GtkWidget *vScaleWidget = d->gtkWidget("GtkVScale");
+            GtkWidget *hScaleWidget = d->gtkWidget(QGtkWidgetId::HScale);
+            GtkWidget *vScaleWidget = d->gtkWidget(QGtkWidgetId::VScale);
 
             QRect groove = proxy()->subControlRect(CC_Slider, option, SC_SliderGroove, widget);
             QRect handle = proxy()->subControlRect(CC_Slider, option, SC_SliderHandle, widget);
@@ -2432,50 +2508,38 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
             QColor highlightAlpha(Qt::white);
             highlightAlpha.setAlpha(80);
 
-            gtk_widget_set_direction(hScaleWidget, slider->upsideDown ?
-                                                       GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
+            gtkPainter->setWidgetDirection(hScaleWidget, slider->upsideDown ?
+                                                         GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
             GtkWidget *scaleWidget = horizontal ? hScaleWidget : vScaleWidget;
             style = gtk_widget_get_style(scaleWidget);
 
             if ((option->subControls & SC_SliderGroove) && groove.isValid()) {
 
                 GtkRange *range = (GtkRange*)scaleWidget;
-                GtkAdjustment *adjustment = gtk_range_get_adjustment(range);
-                if (adjustment) {
-                    gtk_adjustment_configure(adjustment,
-                                                slider->sliderPosition,
-                                                slider->minimum,
-                                                slider->maximum,
-                                                slider->singleStep,
-                                                slider->singleStep,
-                                                slider->pageStep);
-                } else {
-                    adjustment = (GtkAdjustment*)gtk_adjustment_new(slider->sliderPosition,
-                                                                       slider->minimum,
-                                                                       slider->maximum,
-                                                                       slider->singleStep,
-                                                                       slider->singleStep,
-                                                                       slider->pageStep);
-                    gtk_range_set_adjustment(range, adjustment);
-                }
-
-                int outerSize;
-                gtk_range_set_inverted(range, !horizontal);
-                gtk_widget_style_get(scaleWidget, "trough-border", &outerSize, nullptr);
-                outerSize++;
+                gtkPainter->setRangeAdjustment(range,
+                                               slider->sliderPosition,
+                                               slider->minimum,
+                                               slider->maximum,
+                                               slider->singleStep,
+                                               slider->singleStep,
+                                               slider->pageStep);
+
+                const QGtkStyleProperties &properties = d->styleProperties(horizontal ? QGtkWidgetId::HScale
+                                                                                      : QGtkWidgetId::VScale);
+                gtkPainter->setRangeInverted(range, !horizontal);
+                const int outerSize = properties.troughBorder + 1;
 
                 GtkStateType state = qt_gtk_state(option);
                 int focusFrameMargin = 2;
                 QRect grooveRect = option->rect.adjusted(focusFrameMargin, outerSize + focusFrameMargin,
                                    -focusFrameMargin, -outerSize - focusFrameMargin);
 
-                gboolean trough_side_details = false; // Indicates if the upper or lower scale background differs
-                if (!gtk_check_version(2, 10, 0))
-                    gtk_widget_style_get((GtkWidget*)(scaleWidget), "trough-side-details", &trough_side_details, nullptr);
+                // Indicates if the upper or lower scale background differs
+                const gboolean trough_side_details = properties.troughSideDetails;
 
                 if (!trough_side_details) {
                     gtkPainter->paintBox(scaleWidget, "trough", grooveRect, state,
-                                         GTK_SHADOW_IN, style, QString(QLS("p%0")).arg(slider->sliderPosition));
+                                         GTK_SHADOW_IN, style, QGtkPainterExtra(0, slider->sliderPosition));
                 } else {
                     QRect upperGroove = grooveRect;
                     QRect lowerGroove = grooveRect;
@@ -2499,9 +2563,9 @@ void QGtkStyle::drawComplexControl(ComplexControl control, const QStyleOptionCom
                     }
 
                     gtkPainter->paintBox(scaleWidget, "trough-upper", upperGroove, state,
-                                         GTK_SHADOW_IN, style, QString(QLS("p%0")).arg(slider->sliderPosition));
+                                         GTK_SHADOW_IN, style, QGtkPainterExtra(0, slider->sliderPosition));
                     gtkPainter->paintBox(scaleWidget, "trough-lower", lowerGroove, state,
-                                         GTK_SHADOW_IN, style, QString(QLS("p%0")).arg(slider->sliderPosition));
+                                         GTK_SHADOW_IN, style, QGtkPainterExtra(0, slider->sliderPosition));
                 }
             }
 
@@ -2631,7 +2695,7 @@ void QGtkStyle::drawControl(ControlElement element,
     switch (element) {
     case CE_ProgressBarLabel:
         if (const QStyleOptionProgressBar *bar = qstyleoption_cast<const QStyleOptionProgressBar *>(option)) {
-            GtkWidget *gtkProgressBar = d->gtkWidget("GtkProgressBar");
+            GtkWidget *gtkProgressBar = d->gtkWidget(QGtkWidgetId::ProgressBar);
             if (!gtkProgressBar)
                 return;
 
@@ -2735,7 +2799,7 @@ void QGtkStyle::drawControl(ControlElement element,
             if (button->features & QStyleOptionButton::HasMenu)
                 ir = ir.adjusted(0, 0, -pixelMetric(PM_MenuButtonIndicator, button, widget), 0);
 
-            GtkWidget *gtkButton = d->gtkWidget("GtkButton");
+            GtkWidget *gtkButton = d->gtkWidget(QGtkWidgetId::Button);
             QPalette pal = button->palette;
             int labelState = GTK_STATE_INSENSITIVE;
             if (option->state & State_Enabled)
@@ -2756,7 +2820,7 @@ void QGtkStyle::drawControl(ControlElement element,
             bool isRadio = (element == CE_RadioButton);
 
             // Draw prelight background
-            GtkWidget *gtkRadioButton = d->gtkWidget("GtkRadioButton");
+            GtkWidget *gtkRadioButton = d->gtkWidget(QGtkWidgetId::RadioButton);
 
             if (option->state & State_MouseOver) {
                 gtkPainter->paintFlatBox(gtkRadioButton, "checkbutton", option->rect,
@@ -2824,7 +2888,7 @@ void QGtkStyle::drawControl(ControlElement element,
             }
 
             if (!cb->currentText.isEmpty() && !cb->editable) {
-                GtkWidget *gtkCombo = d->gtkWidget("GtkComboBox");
+                GtkWidget *gtkCombo = d->gtkWidget(QGtkWidgetId::ComboBox);
                 QPalette pal = cb->palette;
                 int labelState = GTK_STATE_INSENSITIVE;
 
@@ -2899,7 +2963,7 @@ void QGtkStyle::drawControl(ControlElement element,
         // Draws the header in tables.
         if (const QStyleOptionHeader *header = qstyleoption_cast<const QStyleOptionHeader *>(option)) {
             Q_UNUSED(header);
-            GtkWidget *gtkTreeView = d->gtkWidget("GtkTreeView");
+            GtkWidget *gtkTreeView = d->gtkWidget(QGtkWidgetId::TreeView);
             // Get the middle column
             GtkTreeViewColumn *column = gtk_tree_view_get_column((GtkTreeView*)gtkTreeView, 1);
             Q_ASSERT(column);
@@ -2920,7 +2984,7 @@ void QGtkStyle::drawControl(ControlElement element,
 #ifndef QT_NO_SIZEGRIP
 
     case CE_SizeGrip: {
-        GtkWidget *gtkStatusbar = d->gtkWidget("GtkStatusbar.GtkFrame");
+        GtkWidget *gtkStatusbar = d->gtkWidget(QGtkWidgetId::StatusbarFrame);
         GtkStyle *gtkStatusbarStyle = gtk_widget_get_style(gtkStatusbar);
         QRect gripRect = option->rect.adjusted(0, 0, -gtkStatusbarStyle->xthickness, -gtkStatusbarStyle->ythickness);
         gtkPainter->paintResizeGrip(gtkStatusbar, "statusbar", gripRect, GTK_STATE_NORMAL,
@@ -2933,7 +2997,7 @@ void QGtkStyle::drawControl(ControlElement element,
 #endif // QT_NO_SIZEGRIP
 
     case CE_MenuBarEmptyArea: {
-        GtkWidget *gtkMenubar = d->gtkWidget("GtkMenuBar");
+        GtkWidget *gtkMenubar = d->gtkWidget(QGtkWidgetId::MenuBar);
         GdkColor gdkBg = gtk_widget_get_style(gtkMenubar)->bg[GTK_STATE_NORMAL]; // Theme can depend on transparency
         painter->fillRect(option->rect, QColor(gdkBg.red>>8, gdkBg.green>>8, gdkBg.blue>>8));
         if (widget) { // See CE_MenuBarItem
@@ -2942,8 +3006,7 @@ void QGtkStyle::drawControl(ControlElement element,
             pixmap.fill(Qt::transparent);
             QPainter pmPainter(&pixmap);
             gtkPainter->reset(&pmPainter);
-            GtkShadowType shadow_type;
-            gtk_widget_style_get(gtkMenubar, "shadow-type", &shadow_type, nullptr);
+            const GtkShadowType shadow_type = d->styleProperties(QGtkWidgetId::MenuBar).shadowType;
             gtkPainter->paintBox(gtkMenubar, "menubar", menuBarRect,
                                  GTK_STATE_NORMAL, shadow_type, gtk_widget_get_style(gtkMenubar));
             pmPainter.end();
@@ -2957,8 +3020,8 @@ void QGtkStyle::drawControl(ControlElement element,
         painter->save();
 
         if (const QStyleOptionMenuItem *mbi = qstyleoption_cast<const QStyleOptionMenuItem *>(option)) {
-            GtkWidget *gtkMenubarItem = d->gtkWidget("GtkMenuBar.GtkMenuItem");
-            GtkWidget *gtkMenubar = d->gtkWidget("GtkMenuBar");
+            GtkWidget *gtkMenubarItem = d->gtkWidget(QGtkWidgetId::MenuBarMenuItem);
+            GtkWidget *gtkMenubar = d->gtkWidget(QGtkWidgetId::MenuBar);
 
             style = gtk_widget_get_style(gtkMenubarItem);
 
@@ -2972,8 +3035,7 @@ void QGtkStyle::drawControl(ControlElement element,
                 pixmap.fill(Qt::transparent);
                 QPainter pmPainter(&pixmap);
                 gtkPainter->reset(&pmPainter);
-                GtkShadowType shadow_type;
-                gtk_widget_style_get(gtkMenubar, "shadow-type", &shadow_type, nullptr);
+                const GtkShadowType shadow_type = d->styleProperties(QGtkWidgetId::MenuBar).shadowType;
                 GdkColor gdkBg = gtk_widget_get_style(gtkMenubar)->bg[GTK_STATE_NORMAL]; // Theme can depend on transparency
                 painter->fillRect(option->rect, QColor(gdkBg.red>>8, gdkBg.green>>8, gdkBg.blue>>8));
                 gtkPainter->paintBox(gtkMenubar, "menubar", menuBarRect,
@@ -2997,8 +3059,7 @@ void QGtkStyle::drawControl(ControlElement element,
             QCommonStyle::drawControl(element, &item, painter, widget);
 
             if (act) {
-                GtkShadowType shadowType = GTK_SHADOW_NONE;
-                gtk_widget_style_get (gtkMenubarItem, "selected-shadow-type", &shadowType, nullptr);
+                const GtkShadowType shadowType = d->styleProperties(QGtkWidgetId::MenuBarMenuItem).selectedShadowType;
                 gtkPainter->paintBox(gtkMenubarItem, "menuitem", option->rect.adjusted(0, 0, 0, 3),
                                      GTK_STATE_PRELIGHT, shadowType, style);
                 //draw text
@@ -3015,7 +3076,7 @@ void QGtkStyle::drawControl(ControlElement element,
         break;
 
     case CE_Splitter: {
-        GtkWidget *gtkWindow = d->gtkWidget("GtkWindow"); // The Murrine Engine currently assumes a widget is passed
+        GtkWidget *gtkWindow = d->gtkWidget(QGtkWidgetId::Window); // The Murrine Engine currently assumes a widget is passed
         gtkPainter->paintHandle(gtkWindow, "splitter", option->rect, qt_gtk_state(option), GTK_SHADOW_NONE,
                                 !(option->state & State_Horizontal) ? GTK_ORIENTATION_HORIZONTAL : GTK_ORIENTATION_VERTICAL,
                                 style);
@@ -3035,9 +3096,8 @@ void QGtkStyle::drawControl(ControlElement element,
             if (toolbar->positionWithinLine != QStyleOptionToolBar::End)
                 rect.adjust(0, 0, 1, 0);
 
-            GtkWidget *gtkToolbar = d->gtkWidget("GtkToolbar");
-            GtkShadowType shadow_type = GTK_SHADOW_NONE;
-            gtk_widget_style_get(gtkToolbar, "shadow-type", &shadow_type, nullptr);
+            GtkWidget *gtkToolbar = d->gtkWidget(QGtkWidgetId::Toolbar);
+            const GtkShadowType shadow_type = d->styleProperties(QGtkWidgetId::Toolbar).shadowType;
             gtkPainter->paintBox(gtkToolbar, "toolbar", rect,
                                  GTK_STATE_NORMAL, shadow_type, gtk_widget_get_style(gtkToolbar));
         }
@@ -3052,26 +3112,20 @@ void QGtkStyle::drawControl(ControlElement element,
         if (const QStyleOptionMenuItem *menuItem = qstyleoption_cast<const QStyleOptionMenuItem *>(option)) {
             const int windowsItemHMargin      =  3; // menu item hor text margin
             const int windowsItemVMargin      = 26; // menu item ver text margin
-            GtkWidget *gtkMenuItem = menuItem->checked ? d->gtkWidget("GtkMenu.GtkCheckMenuItem") :
-                                     d->gtkWidget("GtkMenu.GtkMenuItem");
+            const QGtkWidgetId menuItemId = menuItem->checked ? QGtkWidgetId::MenuCheckMenuItem
+                                                              : QGtkWidgetId::MenuMenuItem;
+            GtkWidget *gtkMenuItem = d->gtkWidget(menuItemId);
 
             style = gtk_widget_get_style(gtkMenuItem);
             QColor shadow = option->palette.dark().color();
 
             if (menuItem->menuItemType == QStyleOptionMenuItem::Separator) {
-                GtkWidget *gtkMenuSeparator = d->gtkWidget("GtkMenu.GtkSeparatorMenuItem");
+                GtkWidget *gtkMenuSeparator = d->gtkWidget(QGtkWidgetId::MenuSeparatorMenuItem);
                 painter->setPen(shadow.lighter(106));
-                gboolean wide_separators = 0;
-                gint     separator_height = 0;
-                guint    horizontal_padding = 3;
+                const QGtkStyleProperties &properties = d->styleProperties(QGtkWidgetId::MenuSeparatorMenuItem);
+                const gboolean wide_separators = properties.wideSeparators;
+                const guint horizontal_padding = properties.horizontalPadding;
                 QRect separatorRect = option->rect;
-                if (!gtk_check_version(2, 10, 0)) {
-                    gtk_widget_style_get(gtkMenuSeparator,
-                                           "wide-separators",    &wide_separators,
-                                           "separator-height",   &separator_height,
-                                           "horizontal-padding", &horizontal_padding,
-                                           nullptr);
-                }
                 GtkStyle *gtkMenuSeparatorStyle = gtk_widget_get_style(gtkMenuSeparator);
                 separatorRect.setHeight(option->rect.height() - 2 * gtkMenuSeparatorStyle->ythickness);
                 separatorRect.setWidth(option->rect.width() - 2 * (horizontal_padding + gtkMenuSeparatorStyle->xthickness));
@@ -3103,8 +3157,7 @@ void QGtkStyle::drawControl(ControlElement element,
             bool enabled = menuItem->state & State_Enabled;
             bool ignoreCheckMark = false;
 
-            gint checkSize;
-            gtk_widget_style_get(d->gtkWidget("GtkMenu.GtkCheckMenuItem"), "indicator-size", &checkSize, nullptr);
+            const gint checkSize = d->styleProperties(QGtkWidgetId::MenuCheckMenuItem).indicatorSize;
 
             int checkcol = qMax(menuItem->maxIconWidth, qMax(20, checkSize));
 
@@ -3136,7 +3189,7 @@ void QGtkStyle::drawControl(ControlElement element,
 
                         gtkPainter->setClipRect(checkRect.adjusted(-spacing, -spacing, spacing, spacing));
                         gtkPainter->paintOption(gtkMenuItem, checkRect.translated(-spacing, -spacing), state, shadow,
-                                                style, QLS("option"));
+                                                style, "option");
                         gtkPainter->setClipRect(QRect());
 
                     } else {
@@ -3152,7 +3205,7 @@ void QGtkStyle::drawControl(ControlElement element,
 
                             gtkPainter->setClipRect(checkRect.adjusted(-spacing, -spacing, -spacing, -spacing));
                             gtkPainter->paintCheckbox(gtkMenuItem, checkRect.translated(-spacing, -spacing), state, shadow,
-                                                      style, QLS("check"));
+                                                      style, "check");
                             gtkPainter->setClipRect(QRect());
                         }
                     }
@@ -3285,18 +3338,14 @@ void QGtkStyle::drawControl(ControlElement element,
 
                 QFontMetrics fm(menuitem->font);
                 int arrow_size = fm.ascent() + fm.descent() - 2 * style->ythickness;
-                gfloat arrow_scaling = 0.8;
+                const QGtkStyleProperties &properties = d->styleProperties(menuItemId);
+                const gfloat arrow_scaling = properties.arrowScaling;
                 int extra = 0;
-                if (!gtk_check_version(2, 16, 0)) {
-                    // "arrow-scaling" is actually hardcoded and fails on hardy (see gtk+-2.12/gtkmenuitem.c)
-                    // though the current documentation states otherwise
-                    gtk_widget_style_get(gtkMenuItem, "arrow-scaling", &arrow_scaling, nullptr);
-                    // in versions < 2.16 ythickness was previously subtracted from the arrow_size
+                // in versions < 2.16 ythickness was previously subtracted from the arrow_size
+                if (!gtk_check_version(2, 16, 0))
                     extra = 2 * style->ythickness;
-                }
 
-                int horizontal_padding;
-                gtk_widget_style_get(gtkMenuItem, "horizontal-padding", &horizontal_padding, nullptr);
+                const int horizontal_padding = properties.horizontalPadding;
 
                 const int dim = static_cast<int>(arrow_size * arrow_scaling) + extra;
                 int xpos = menuItem->rect.left() + menuItem->rect.width() - horizontal_padding - dim;
@@ -3314,12 +3363,11 @@ void QGtkStyle::drawControl(ControlElement element,
 
     case CE_PushButton:
         if (const QStyleOptionButton *btn = qstyleoption_cast<const QStyleOptionButton *>(option)) {
-            GtkWidget *gtkButton = d->gtkWidget("GtkButton");
+            GtkWidget *gtkButton = d->gtkWidget(QGtkWidgetId::Button);
             proxy()->drawControl(CE_PushButtonBevel, btn, painter, widget);
             QStyleOptionButton subopt = *btn;
             subopt.rect = subElementRect(SE_PushButtonContents, btn, widget);
-            gint interiorFocus = true;
-            gtk_widget_style_get(gtkButton, "interior-focus", &interiorFocus, nullptr);
+            const gboolean interiorFocus = d->styleProperties(QGtkWidgetId::Button).interiorFocus;
             GtkStyle *gtkButtonStyle = gtk_widget_get_style(gtkButton);
             int xt = interiorFocus ? gtkButtonStyle->xthickness : 0;
             int yt = interiorFocus ? gtkButtonStyle->ythickness : 0;
@@ -3341,7 +3389,7 @@ void QGtkStyle::drawControl(ControlElement element,
 
     case CE_TabBarTabShape:
         if (const QStyleOptionTab *tab = qstyleoption_cast<const QStyleOptionTab *>(option)) {
-            GtkWidget *gtkNotebook = d->gtkWidget("GtkNotebook");
+            GtkWidget *gtkNotebook = d->gtkWidget(QGtkWidgetId::Notebook);
             style = gtk_widget_get_style(gtkNotebook);
 
             QRect rect = option->rect;
@@ -3408,7 +3456,7 @@ void QGtkStyle::drawControl(ControlElement element,
     case CE_ProgressBarGroove:
         if (const QStyleOptionProgressBar *bar = qstyleoption_cast<const QStyleOptionProgressBar *>(option)) {
             Q_UNUSED(bar);
-            GtkWidget *gtkProgressBar = d->gtkWidget("GtkProgressBar");
+            GtkWidget *gtkProgressBar = d->gtkWidget(QGtkWidgetId::ProgressBar);
             GtkStateType state = qt_gtk_state(option);
             gtkPainter->paintBox(gtkProgressBar, "trough", option->rect, state, GTK_SHADOW_IN, gtk_widget_get_style(gtkProgressBar));
         }
@@ -3418,7 +3466,7 @@ void QGtkStyle::drawControl(ControlElement element,
     case CE_ProgressBarContents:
         if (const QStyleOptionProgressBar *bar = qstyleoption_cast<const QStyleOptionProgressBar *>(option)) {
             GtkStateType state = option->state & State_Enabled ? GTK_STATE_NORMAL : GTK_STATE_INSENSITIVE;
-            GtkWidget *gtkProgressBar = d->gtkWidget("GtkProgressBar");
+            GtkWidget *gtkProgressBar = d->gtkWidget(QGtkWidgetId::ProgressBar);
             style = gtk_widget_get_style(gtkProgressBar);
             gtkPainter->paintBox(gtkProgressBar, "trough", option->rect, state, GTK_SHADOW_IN, style);
             int xt = style->xthickness;
@@ -3491,12 +3539,10 @@ void QGtkStyle::drawControl(ControlElement element,
                 progressBar.setRect(rect.left() + step, rect.top(), slideWidth / 2, rect.height());
             }
 
-            QString key = QString(QLS("%0")).arg(fakePos);
-            if (inverted) {
-                key += QLatin1String("inv");
+            if (inverted)
                 gtkPainter->setFlipHorizontal(true);
-            }
-            gtkPainter->paintBox(gtkProgressBar, "bar", progressBar, GTK_STATE_SELECTED, GTK_SHADOW_OUT, style, key);
+            gtkPainter->paintBox(gtkProgressBar, "bar", progressBar, GTK_STATE_SELECTED, GTK_SHADOW_OUT, style,
+                                 QGtkPainterExtra(inverted ? QGtkPainterExtra::Inverted : 0, fakePos));
         }
 
         break;
@@ -3631,7 +3677,7 @@ QRect QGtkStyle::subControlRect(ComplexControl control, const QStyleOptionComple
 
     case CC_SpinBox:
         if (const QStyleOptionSpinBox *spinbox = qstyleoption_cast<const QStyleOptionSpinBox *>(option)) {
-            GtkWidget *gtkSpinButton = d->gtkWidget("GtkSpinButton");
+            GtkWidget *gtkSpinButton = d->gtkWidget(QGtkWidgetId::SpinButton);
             int center = spinbox->rect.height() / 2;
             GtkStyle *gtkSpinButtonStyle = gtk_widget_get_style(gtkSpinButton);
             int xt = spinbox->frame ? gtkSpinButtonStyle->xthickness : 0;
@@ -3772,21 +3818,21 @@ QRect QGtkStyle::subControlRect(ComplexControl control, const QStyleOptionComple
     case CC_ComboBox:
         if (const QStyleOptionComboBox *box = qstyleoption_cast<const QStyleOptionComboBox *>(option)) {
             // We employ the gtk widget to position arrows and separators for us
-            GtkWidget *gtkCombo = box->editable ? d->gtkWidget("GtkComboBoxEntry")
-                                                : d->gtkWidget("GtkComboBox");
+            GtkWidget *gtkCombo = box->editable ? d->gtkWidget(QGtkWidgetId::ComboBoxEntry)
+                                                : d->gtkWidget(QGtkWidgetId::ComboBox);
             gtk_widget_set_direction(gtkCombo, (option->direction == Qt::RightToLeft) ? GTK_TEXT_DIR_RTL : GTK_TEXT_DIR_LTR);
             GtkAllocation geometry = {0, 0, qMax(0, option->rect.width()), qMax(0, option->rect.height())};
             gtk_widget_size_allocate(gtkCombo, &geometry);
             int appears_as_list = !proxy()->styleHint(QStyle::SH_ComboBox_Popup, option, widget);
-            QHashableLatin1Literal arrowPath("GtkComboBoxEntry.GtkToggleButton");
+            QGtkWidgetId arrowId = QGtkWidgetId::ComboBoxEntryToggleButton;
             if (!box->editable) {
                 if (appears_as_list)
-                    arrowPath = "GtkComboBox.GtkToggleButton";
+                    arrowId = QGtkWidgetId::ComboBoxToggleButton;
                 else
-                    arrowPath = "GtkComboBox.GtkToggleButton.GtkHBox.GtkArrow";
+                    arrowId = QGtkWidgetId::ComboBoxToggleButtonHBoxArrow;
             }
 
-            GtkWidget *arrowWidget = d->gtkWidget(arrowPath);
+            GtkWidget *arrowWidget = d->gtkWidget(arrowId);
             if (!arrowWidget)
                 return QCommonStyle::subControlRect(control, option, subControl, widget);
 
@@ -3859,7 +3905,7 @@ QSize QGtkStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
         break;
     case CT_ToolButton:
         if (const QStyleOptionToolButton *toolbutton = qstyleoption_cast<const QStyleOptionToolButton *>(option)) {
-            GtkWidget *gtkButton = d->gtkWidget("GtkToolButton.GtkButton");
+            GtkWidget *gtkButton = d->gtkWidget(QGtkWidgetId::ToolButtonButton);
             GtkStyle *gtkButtonStyle = gtk_widget_get_style(gtkButton);
             newSize = size + QSize(2 * gtkButtonStyle->xthickness, 2 + 2 * gtkButtonStyle->ythickness);
             if (widget && qobject_cast<QToolBar *>(widget->parentWidget())) {
@@ -3875,7 +3921,7 @@ QSize QGtkStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
         break;
     case CT_SpinBox:
         // QSpinBox does some nasty things that depends on CT_LineEdit
-        newSize = newSize + QSize(0, -gtk_widget_get_style(d->gtkWidget("GtkSpinButton"))->ythickness * 2);
+        newSize = newSize + QSize(0, -gtk_widget_get_style(d->gtkWidget(QGtkWidgetId::SpinButton))->ythickness * 2);
         break;
     case CT_RadioButton:
     case CT_CheckBox:
@@ -3886,19 +3932,18 @@ QSize QGtkStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
             if (!btn->icon.isNull() && btn->iconSize.height() > 16)
                 newSize -= QSize(0, 2); // From cleanlooksstyle
             newSize += QSize(0, 1);
-            GtkWidget *gtkButton = d->gtkWidget("GtkButton");
-            gint focusPadding, focusWidth;
-            gtk_widget_style_get(gtkButton, "focus-padding", &focusPadding, nullptr);
-            gtk_widget_style_get(gtkButton, "focus-line-width", &focusWidth, nullptr);
+            GtkWidget *gtkButton = d->gtkWidget(QGtkWidgetId::Button);
+            const QGtkStyleProperties &properties = d->styleProperties(QGtkWidgetId::Button);
+            const gint focusPadding = properties.focusPadding;
+            const gint focusWidth = properties.focusLineWidth;
             newSize = size;
             GtkStyle *gtkButtonStyle = gtk_widget_get_style(gtkButton);
             newSize += QSize(2*gtkButtonStyle->xthickness + 4, 2*gtkButtonStyle->ythickness);
             newSize += QSize(2*(focusWidth + focusPadding + 2), 2*(focusWidth + focusPadding));
 
-            GtkWidget *gtkButtonBox = d->gtkWidget("GtkHButtonBox");
-            gint minWidth = 85, minHeight = 0;
-            gtk_widget_style_get(gtkButtonBox, "child-min-width", &minWidth,
-                                   "child-min-height", &minHeight, nullptr);
+            const QGtkStyleProperties &buttonBoxProperties = d->styleProperties(QGtkWidgetId::HButtonBox);
+            const gint minWidth = buttonBoxProperties.childMinWidth;
+            const gint minHeight = buttonBoxProperties.childMinHeight;
             if (!btn->text.isEmpty() && newSize.width() < minWidth)
                 newSize.setWidth(minWidth);
             if (newSize.height() < minHeight)
@@ -3906,12 +3951,12 @@ QSize QGtkStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
         }
         break;
     case CT_Slider: {
-        GtkWidget *gtkSlider = d->gtkWidget("GtkHScale");
+        GtkWidget *gtkSlider = d->gtkWidget(QGtkWidgetId::HScale);
         GtkStyle *gtkSliderStyle = gtk_widget_get_style(gtkSlider);
         newSize = size + QSize(2*gtkSliderStyle->xthickness, 2*gtkSliderStyle->ythickness); }
         break;
     case CT_LineEdit: {
-        GtkWidget *gtkEntry = d->gtkWidget("GtkEntry");
+        GtkWidget *gtkEntry = d->gtkWidget(QGtkWidgetId::Entry);
         GtkStyle *gtkEntryStyle = gtk_widget_get_style(gtkEntry);
         newSize = size + QSize(2*gtkEntryStyle->xthickness, 2 + 2*gtkEntryStyle->ythickness); }
         break;
@@ -3920,7 +3965,7 @@ QSize QGtkStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
         break;
     case CT_ComboBox:
         if (const QStyleOptionComboBox *combo = qstyleoption_cast<const QStyleOptionComboBox *>(option)) {
-            GtkWidget *gtkCombo = d->gtkWidget("GtkComboBox");
+            GtkWidget *gtkCombo = d->gtkWidget(QGtkWidgetId::ComboBox);
             QRect arrowButtonRect = proxy()->subControlRect(CC_ComboBox, combo, SC_ComboBoxArrow, widget);
             GtkStyle *gtkComboStyle = gtk_widget_get_style(gtkCombo);
             newSize = size + QSize(12 + arrowButtonRect.width() + 2*gtkComboStyle->xthickness, 4 + 2*gtkComboStyle->ythickness);
@@ -3983,14 +4028,14 @@ QSize QGtkStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
 
             int textMargin = 8;
             if (menuItem->menuItemType == QStyleOptionMenuItem::Separator) {
-                GtkWidget *gtkMenuSeparator = d->gtkWidget("GtkMenu.GtkSeparatorMenuItem");
+                GtkWidget *gtkMenuSeparator = d->gtkWidget(QGtkWidgetId::MenuSeparatorMenuItem);
                 GtkRequisition sizeReq = {0, 0};
                 gtk_widget_size_request(gtkMenuSeparator, &sizeReq);
                 newSize = QSize(newSize.width(), sizeReq.height);
                 break;
             }
 
-            GtkWidget *gtkMenuItem = d->gtkWidget("GtkMenu.GtkCheckMenuItem");
+            GtkWidget *gtkMenuItem = d->gtkWidget(QGtkWidgetId::MenuCheckMenuItem);
             GtkStyle* style = gtk_widget_get_style(gtkMenuItem);
 
             // Note we get the perfect height for the default font since we
@@ -4001,8 +4046,7 @@ QSize QGtkStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
             newSize.setHeight(qMax(newSize.height() - 4, sizeReq.height));
             newSize += QSize(textMargin + style->xthickness - 1, 0);
 
-            gint checkSize;
-            gtk_widget_style_get(gtkMenuItem, "indicator-size", &checkSize, nullptr);
+            const gint checkSize = d->styleProperties(QGtkWidgetId::MenuCheckMenuItem).indicatorSize;
             newSize.setWidth(newSize.width() + qMax(0, checkSize - 20));
         }
         break;
@@ -4166,12 +4210,10 @@ QRect QGtkStyle::subElementRect(SubElement element, const QStyleOption *option,
         return option->rect;
     case SE_PushButtonContents:
         if (!gtk_check_version(2, 10, 0)) {
-            GtkWidget *gtkButton = d->gtkWidget("GtkButton");
-            GtkBorder *border = nullptr;
-            gtk_widget_style_get(gtkButton, "inner-border", &border, nullptr);
-            if (border) {
-                r = option->rect.adjusted(border->left, border->top, -border->right, -border->bottom);
-                gtk_border_free(border);
+            const QGtkStyleProperties &properties = d->styleProperties(QGtkWidgetId::Button);
+            if (properties.hasInnerBorder) {
+                const GtkBorder &border = properties.innerBorder;
+                r = option->rect.adjusted(border.left, border.top, -border.right, -border.bottom);
             } else {
                 r = option->rect.adjusted(1, 1, -1, -1);
             }
@@ -39,8 +39,11 @@
 #include <QHash>
 #include <QUrl>
 #include <QDebug>
+#include <QElapsedTimer>
 
 #include "qgtk2painter_p.h"
+#include "qgtkpixmapcache_p.h"
+#include "qgtkstats_p.h"
 #include <private/qapplication_p.h>
 #include <private/qiconloader_p.h>
 #include <qpa/qplatformfontdatabase.h>
@@ -48,7 +51,6 @@
 #include <QMenu>
 #include <QStyle>
 #include <QApplication>
-#include <QPixmapCache>
 #include <QStatusBar>
 #include <QMenuBar>
 #include <QToolBar>
@@ -89,6 +91,7 @@ QT_BEGIN_NAMESPACE
 static void gtkStyleSetCallback(GtkWidget*)
 {
     qRegisterMetaType<QGtkStylePrivate *>();
+    QGtkStylePrivate::clearStyleProperties();
 
     // We have to let this function return and complete the event
     // loop to ensure that all gtk widgets have been styled before
@@ -144,6 +147,60 @@ bool QGtkStyleFilter::eventFilter(QObject *obj, QEvent *e)
 
 QList<QGtkStylePrivate *> QGtkStylePrivate::instances;
 QGtkStylePrivate::WidgetMap *QGtkStylePrivate::widgetMap = nullptr;
+GtkWidget *QGtkStylePrivate::widgetTable[int(QGtkWidgetId::Count)];
+bool QGtkStylePrivate::widgetTableValid = false;
+bool QGtkStylePrivate::widgetMissing[int(QGtkWidgetId::Count)];
+quint32 QGtkStylePrivate::createdWidgetFamilies = 0;
+QGtkStyleProperties QGtkStylePrivate::widgetProperties[int(QGtkWidgetId::Count)];
+GtkWidget *QGtkStylePrivate::propertiesSources[int(QGtkWidgetId::Count)];
+
+// In the order of QGtkWidgetId
+static const QHashableLatin1Literal qt_gtk_widget_paths[] = {
+    "GtkWindow",
+    "GtkArrow",
+    "GtkButton",
+    "GtkCheckButton",
+    "GtkRadioButton",
+    "GtkComboBox",
+    "GtkComboBox.GtkFrame",
+    "GtkComboBox.GtkToggleButton",
+    "GtkComboBox.GtkToggleButton.GtkArrow",
+    "GtkComboBox.GtkToggleButton.GtkHBox.GtkArrow",
+    "GtkComboBox.GtkToggleButton.GtkHBox.GtkVSeparator",
+    "GtkComboBoxEntry",
+    "GtkComboBoxEntry.GtkEntry",
+    "GtkComboBoxEntry.GtkToggleButton",
+    "GtkComboBoxEntry.GtkToggleButton.GtkArrow",
+    "GtkComboBoxEntry.GtkToggleButton.GtkHBox.GtkArrow",
+    "GtkComboBoxEntry.GtkToggleButton.GtkHBox.GtkVSeparator",
+    "GtkEntry",
+    "GtkFrame",
+    "GtkHButtonBox",
+    "GtkHScale",
+    "GtkVScale",
+    "GtkHScrollbar",
+    "GtkVScrollbar",
+    "GtkMenu",
+    "GtkMenu.GtkCheckMenuItem",
+    "GtkMenu.GtkMenuItem",
+    "GtkMenu.GtkSeparatorMenuItem",
+    "GtkMenuBar",
+    "GtkMenuBar.GtkMenuItem",
+    "GtkNotebook",
+    "GtkProgressBar",
+    "GtkScrolledWindow",
+    "GtkSpinButton",
+    "GtkStatusbar",
+    "GtkStatusbar.GtkFrame",
+    "GtkToolButton.GtkButton",
+    "GtkToolbar",
+    "GtkToolbar.GtkSeparatorToolItem",
+    "GtkTreeView",
+    "GtkTreeView.GtkButton"
+};
+
+static_assert(sizeof(qt_gtk_widget_paths) / sizeof(qt_gtk_widget_paths[0]) == int(QGtkWidgetId::Count),
+              "qt_gtk_widget_paths must list every QGtkWidgetId");
 
 QGtkStylePrivate::QGtkStylePrivate()
   : QCommonStylePrivate()
@@ -174,20 +231,168 @@ QGtkPainter* QGtkStylePrivate::gtkPainter(QPainter *painter)
 GtkWidget* QGtkStylePrivate::gtkWidget(const QHashableLatin1Literal &path)
 {
     GtkWidget *widget = gtkWidgetMap()->value(path);
-    if (!widget) {
-        // Theme might have rearranged widget internals
+    if (!widget && createWidgetFamily(path))
         widget = gtkWidgetMap()->value(path);
-    }
     return widget;
 }
 
 GtkStyle* QGtkStylePrivate::gtkStyle(const QHashableLatin1Literal &path)
 {
-    if (GtkWidget *w = gtkWidgetMap()->value(path))
+    if (GtkWidget *w = gtkWidget(path))
+        return gtk_widget_get_style(w);
+    return nullptr;
+}
+
+GtkStyle* QGtkStylePrivate::gtkStyle(QGtkWidgetId id)
+{
+    if (GtkWidget *w = gtkWidget(id))
         return gtk_widget_get_style(w);
     return nullptr;
 }
 
+QHashableLatin1Literal QGtkStylePrivate::widgetPath(QGtkWidgetId id)
+{
+    return qt_gtk_widget_paths[int(id)];
+}
+
+GtkWidget* QGtkStylePrivate::createWidget(QGtkWidgetId id)
+{
+    // Paths that some themes never get, like the combo box parts of
+    // appears-as-list, are asked for on every paint; remember the miss
+    if (createWidgetFamily(widgetPath(id)))
+        updateWidgetTable();
+    if (!widgetTable[int(id)])
+        widgetMissing[int(id)] = true;
+    return widgetTable[int(id)];
+}
+
+static inline bool qt_gtk_is_a(GtkWidget *widget, GType type)
+{
+    return G_TYPE_CHECK_INSTANCE_TYPE(widget, type);
+}
+
+// The defaults are those the style used when GTK+ was too old for a property
+static void qt_gtk_read_style_properties(GtkWidget *widget, QGtkStyleProperties *p)
+{
+    memset(p, 0, sizeof(QGtkStyleProperties));
+    p->troughBorder = 1;
+    p->troughUnderSteppers = true;
+    p->stepperSize = 14;
+    p->scrollbarSpacing = 3;
+    p->arrowScaling = 0.7;
+    p->arrowSize = 15;
+    p->childMinWidth = 85;
+    if (!widget)
+        return;
+
+    const bool gtk2_10 = !gtk_check_version(2, 10, 0);
+    const bool gtk2_12 = !gtk_check_version(2, 12, 0);
+    gtk_widget_style_get(widget,
+                         "interior-focus", &p->interiorFocus,
+                         "focus-line-width", &p->focusLineWidth,
+                         "focus-padding", &p->focusPadding, nullptr);
+    if (gtk2_10)
+        gtk_widget_style_get(widget,
+                             "wide-separators", &p->wideSeparators,
+                             "separator-height", &p->separatorHeight, nullptr);
+
+    if (qt_gtk_is_a(widget, gtk_button_get_type())) {
+        gtk_widget_style_get(widget,
+                             "child-displacement-x", &p->childDisplacementX,
+                             "child-displacement-y", &p->childDisplacementY, nullptr);
+        GtkBorder *border = nullptr;
+        if (gtk2_10)
+            gtk_widget_style_get(widget, "inner-border", &border, nullptr);
+        if (border) {
+            p->hasInnerBorder = true;
+            p->innerBorder = *border;
+            gtk_border_free(border);
+        }
+    }
+    if (qt_gtk_is_a(widget, gtk_check_button_get_type()))
+        gtk_widget_style_get(widget,
+                             "indicator-size", &p->indicatorSize,
+                             "indicator-spacing", &p->indicatorSpacing, nullptr);
+    if (qt_gtk_is_a(widget, gtk_range_get_type())) {
+        gtk_widget_style_get(widget,
+                             "slider-width", &p->sliderWidth,
+                             "trough-border", &p->troughBorder,
+                             "stepper-size", &p->stepperSize, nullptr);
+        if (gtk2_10)
+            gtk_widget_style_get(widget,
+                                 "trough-side-details", &p->troughSideDetails,
+                                 "trough-under-steppers", &p->troughUnderSteppers, nullptr);
+    }
+    if (qt_gtk_is_a(widget, gtk_scale_get_type()))
+        gtk_widget_style_get(widget, "slider-length", &p->sliderLength, nullptr);
+    if (qt_gtk_is_a(widget, gtk_scrolled_window_get_type())) {
+        gtk_widget_style_get(widget, "scrollbar-spacing", &p->scrollbarSpacing, nullptr);
+        if (gtk2_12)
+            gtk_widget_style_get(widget, "scrollbars-within-bevel", &p->scrollbarsWithinBevel, nullptr);
+    }
+    if (qt_gtk_is_a(widget, gtk_menu_get_type())) {
+        gtk_widget_style_get(widget, "horizontal-offset", &p->horizontalOffset, nullptr);
+        // horizontal-padding is used by Maemo to get thicker borders
+        if (gtk2_10)
+            gtk_widget_style_get(widget, "horizontal-padding", &p->horizontalPadding, nullptr);
+    }
+    if (qt_gtk_is_a(widget, gtk_menu_item_get_type())) {
+        p->horizontalPadding = 3;
+        p->arrowScaling = 0.8;
+        p->selectedShadowType = GTK_SHADOW_NONE;
+        gtk_widget_style_get(widget,
+                             "horizontal-padding", &p->horizontalPadding,
+                             "selected-shadow-type", &p->selectedShadowType, nullptr);
+        // "arrow-scaling" is actually hardcoded and fails on hardy (see gtk+-2.12/gtkmenuitem.c)
+        // though the current documentation states otherwise
+        if (!gtk_check_version(2, 16, 0))
+            gtk_widget_style_get(widget, "arrow-scaling", &p->arrowScaling, nullptr);
+    }
+    if (qt_gtk_is_a(widget, gtk_check_menu_item_get_type()))
+        gtk_widget_style_get(widget, "indicator-size", &p->indicatorSize, nullptr);
+    if (qt_gtk_is_a(widget, gtk_arrow_get_type()) && gtk2_12)
+        gtk_widget_style_get(widget, "arrow-scaling", &p->arrowScaling, nullptr);
+    if (qt_gtk_is_a(widget, gtk_combo_box_get_type())) {
+        gtk_widget_style_get(widget, "appears-as-list", &p->appearsAsList, nullptr);
+        if (gtk2_12)
+            gtk_widget_style_get(widget, "arrow-size", &p->arrowSize, nullptr);
+    }
+    if (qt_gtk_is_a(widget, gtk_toolbar_get_type()) || qt_gtk_is_a(widget, gtk_menu_bar_get_type())
+            || qt_gtk_is_a(widget, gtk_statusbar_get_type()))
+        gtk_widget_style_get(widget, "shadow-type", &p->shadowType, nullptr);
+    if (qt_gtk_is_a(widget, gtk_button_box_get_type()))
+        gtk_widget_style_get(widget,
+                             "child-min-width", &p->childMinWidth,
+                             "child-min-height", &p->childMinHeight, nullptr);
+}
+
+const QGtkStyleProperties &QGtkStylePrivate::styleProperties(QGtkWidgetId id)
+{
+    QGtkStyleProperties &properties = widgetProperties[int(id)];
+    GtkWidget *widget = gtkWidget(id);
+    // the widget may have been replaced when the map was rebuilt
+    if (!widget || widget != propertiesSources[int(id)]) {
+        qt_gtk_read_style_properties(widget, &properties);
+        propertiesSources[int(id)] = widget;
+    }
+    return properties;
+}
+
+void QGtkStylePrivate::clearStyleProperties()
+{
+    memset(propertiesSources, 0, sizeof(propertiesSources));
+}
+
+// Looks the known paths up in the widget map once after it changed
+void QGtkStylePrivate::updateWidgetTable()
+{
+    const WidgetMap *map = gtkWidgetMap();
+    for (int i = 0; i < int(QGtkWidgetId::Count); ++i)
+        widgetTable[i] = map->value(qt_gtk_widget_paths[i]);
+    memset(widgetMissing, 0, sizeof(widgetMissing));
+    widgetTableValid = true;
+}
+
 void QGtkStylePrivate::gtkWidgetSetFocus(GtkWidget *widget, bool focus)
 {
     GdkEvent *event = gdk_event_new(GDK_FOCUS_CHANGE);
@@ -242,6 +447,46 @@ void QGtkStylePrivate::initGtkTreeview() const
 }
 
 
+namespace {
+
+enum Family {
+    ToolButton, Arrow, HButtonBox, CheckButton, RadioButton, ComboBox, ComboBoxEntry,
+    Entry, Frame, Expander, Statusbar, HScale, VScale, HScrollbar, VScrollbar,
+    ScrolledWindow, Menu, Notebook, ProgressBar, SpinButton, Toolbar, TreeView
+};
+
+// Top level classes of the proto widgets, each made with its children
+static const struct {
+    const char *root;
+    Family family;
+} qt_gtk_widget_roots[] = {
+    { "GtkToolButton", ToolButton },
+    { "GtkArrow", Arrow },
+    { "GtkHButtonBox", HButtonBox },
+    { "GtkCheckButton", CheckButton },
+    { "GtkRadioButton", RadioButton },
+    { "GtkComboBox", ComboBox },
+    { "GtkComboBoxEntry", ComboBoxEntry },
+    { "GtkEntry", Entry },
+    { "GtkFrame", Frame },
+    { "GtkExpander", Expander },
+    { "GtkStatusbar", Statusbar },
+    { "GtkHScale", HScale },
+    { "GtkVScale", VScale },
+    { "GtkHScrollbar", HScrollbar },
+    { "GtkVScrollbar", VScrollbar },
+    { "GtkScrolledWindow", ScrolledWindow },
+    { "GtkMenuBar", Menu },
+    { "GtkMenu", Menu },
+    { "GtkNotebook", Notebook },
+    { "GtkProgressBar", ProgressBar },
+    { "GtkSpinButton", SpinButton },
+    { "GtkToolbar", Toolbar },
+    { "GtkTreeView", TreeView }
+};
+
+}
+
 /* \internal
  * Initializes a number of gtk widgets that we can later on use to determine some of our styles.
  * The widgets are cached.
@@ -277,6 +522,7 @@ void QGtkStylePrivate::initGtkWidgets() const
     QHashableLatin1Literal widgetPath = QHashableLatin1Literal::fromData(strdup("GtkWindow"));
     removeWidgetFromMap(widgetPath);
     gtkWidgetMap()->insert(widgetPath, gtkWindow);
+    widgetTableValid = false;
 
 
     // Make all other widgets. respect the text direction
@@ -284,16 +530,89 @@ void QGtkStylePrivate::initGtkWidgets() const
         gtk_widget_set_default_direction(GTK_TEXT_DIR_RTL);
 
     if (!gtkWidgetMap()->contains("GtkButton")) {
+        // Only the button is made up front, it tells us about theme
+        // changes; createWidgetFamily() makes the others when needed
+        QElapsedTimer timer;
+        timer.start();
         GtkWidget *gtkButton = gtk_button_new();
         addWidget(gtkButton);
         g_signal_connect(gtkButton, "style-set", G_CALLBACK(gtkStyleSetCallback), 0);
+        qCDebug(lcGtkStats, "made the GtkButton proto widgets in %.3f ms",
+                timer.nsecsElapsed() / 1e6);
+        // QT6GTK2_LAZY_WIDGETS=0 makes all of them up front, as the style
+        // used to, so that startup can be compared
+        if (qgetenv("QT6GTK2_LAZY_WIDGETS") == "0") {
+            for (const auto &root : qt_gtk_widget_roots)
+                createWidgetFamily(QHashableLatin1Literal::fromData(root.root));
+        }
+    }
+    else // Rebuild map
+    {
+        // When styles change subwidgets can get rearranged
+        // as with the combo box. We need to update the widget map
+        // to reflect this;
+        QHash<QHashableLatin1Literal, GtkWidget*> oldMap = *gtkWidgetMap();
+        gtkWidgetMap()->clear();
+        widgetTableValid = false;
+        QHashIterator<QHashableLatin1Literal, GtkWidget*> it(oldMap);
+        while (it.hasNext()) {
+            it.next();
+            if (!strchr(it.key().data(), '.')) {
+                addAllSubWidgets(it.value());
+            }
+            free(const_cast<char *>(it.key().data()));
+        }
+    }
+}
+
+/* \internal
+ * Makes the proto widgets under the top level class of path, the first
+ * time one of them is asked for. Returns whether any were made.
+ */
+bool QGtkStylePrivate::createWidgetFamily(const QHashableLatin1Literal &path)
+{
+    // no GTK+ without the window, see initGtkWidgets()
+    if (!gtkWidgetMap()->contains("GtkWindow"))
+        return false;
+
+    const char *dot = strchr(path.data(), '.');
+    const int rootSize = dot ? int(dot - path.data()) : path.size();
+    int family = -1;
+    for (const auto &root : qt_gtk_widget_roots) {
+        if (int(qstrlen(root.root)) == rootSize && !qstrncmp(root.root, path.data(), rootSize)) {
+            family = root.family;
+            break;
+        }
+    }
+    if (family < 0 || createdWidgetFamilies & (1u << family))
+        return false;
+    createdWidgetFamilies |= 1u << family;
+
+    QElapsedTimer timer;
+    timer.start();
+    switch (family) {
+    case ToolButton:
         addWidget((GtkWidget*)gtk_tool_button_new(nullptr, "Qt"));
+        break;
+    case Arrow:
         addWidget(gtk_arrow_new(GTK_ARROW_DOWN, GTK_SHADOW_NONE));
+        break;
+    case HButtonBox:
         addWidget(gtk_hbutton_box_new());
+        break;
+    case CheckButton:
         addWidget(gtk_check_button_new());
+        break;
+    case RadioButton:
         addWidget(gtk_radio_button_new(nullptr));
+        break;
+    case ComboBox:
         addWidget(gtk_combo_box_new());
+        break;
+    case ComboBoxEntry:
         addWidget(gtk_combo_box_entry_new());
+        break;
+    case Entry: {
         GtkWidget *entry = gtk_entry_new();
         // gtk-im-context-none is supported in gtk+ since 2.19.5
         // and also exists in gtk3
@@ -304,42 +623,63 @@ void QGtkStylePrivate::initGtkWidgets() const
         // to gtk-im-context-simple if gtk-im-context-none doesn't
         // exists.
         g_object_set(entry, "im-module", "gtk-im-context-none", nullptr);
+        // See https://bugzilla.mozilla.org/show_bug.cgi?id=405421 for info about this hack
+        g_object_set_data(G_OBJECT(entry), "transparent-bg-hint", GINT_TO_POINTER(true));
         addWidget(entry);
+        break;
+    }
+    case Frame:
         addWidget(gtk_frame_new(nullptr));
+        break;
+    case Expander:
         addWidget(gtk_expander_new(""));
+        break;
+    case Statusbar:
         addWidget(gtk_statusbar_new());
+        break;
+    case HScale:
         addWidget(gtk_hscale_new((GtkAdjustment*)gtk_adjustment_new(1, 0, 1, 0, 0, 0)));
+        break;
+    case VScale:
+        addWidget(gtk_vscale_new((GtkAdjustment*)gtk_adjustment_new(1, 0, 1, 0, 0, 0)));
+        break;
+    case HScrollbar:
         addWidget(gtk_hscrollbar_new(nullptr));
+        break;
+    case VScrollbar:
+        addWidget(gtk_vscrollbar_new(nullptr));
+        break;
+    case ScrolledWindow:
         addWidget(gtk_scrolled_window_new(nullptr, nullptr));
-
-        initGtkMenu();
+        break;
+    case Menu:
+        if (!instances.isEmpty())
+            instances.last()->initGtkMenu();
+        break;
+    case Notebook:
         addWidget(gtk_notebook_new());
+        break;
+    case ProgressBar:
         addWidget(gtk_progress_bar_new());
+        break;
+    case SpinButton:
         addWidget(gtk_spin_button_new((GtkAdjustment*)gtk_adjustment_new(1, 0, 1, 0, 0, 0), 0.1, 3));
+        break;
+    case Toolbar: {
         GtkWidget *toolbar = gtk_toolbar_new();
         g_signal_connect (toolbar, "notify::toolbar-style", G_CALLBACK (update_toolbar_style), toolbar);
         gtk_toolbar_insert((GtkToolbar*)toolbar, gtk_separator_tool_item_new(), -1);
         addWidget(toolbar);
-        initGtkTreeview();
-        addWidget(gtk_vscale_new((GtkAdjustment*)gtk_adjustment_new(1, 0, 1, 0, 0, 0)));
-        addWidget(gtk_vscrollbar_new(nullptr));
+        break;
     }
-    else // Rebuild map
-    {
-        // When styles change subwidgets can get rearranged
-        // as with the combo box. We need to update the widget map
-        // to reflect this;
-        QHash<QHashableLatin1Literal, GtkWidget*> oldMap = *gtkWidgetMap();
-        gtkWidgetMap()->clear();
-        QHashIterator<QHashableLatin1Literal, GtkWidget*> it(oldMap);
-        while (it.hasNext()) {
-            it.next();
-            if (!strchr(it.key().data(), '.')) {
-                addAllSubWidgets(it.value());
-            }
-            free(const_cast<char *>(it.key().data()));
-        }
+    case TreeView:
+        if (!instances.isEmpty())
+            instances.last()->initGtkTreeview();
+        break;
     }
+    qCDebug(lcGtkStats, "made the %.*s proto widgets in %.3f ms", rootSize, path.data(),
+            timer.nsecsElapsed() / 1e6);
+    return true;
 }
 
 /*! \internal
@@ -372,7 +712,7 @@ QString QGtkStylePrivate::getThemeName()
 int QGtkStylePrivate::getSpinboxArrowSize() const
 {
     const int MIN_ARROW_WIDTH = 6;
-    GtkWidget *spinButton = gtkWidget("GtkSpinButton");
+    GtkWidget *spinButton = gtkWidget(QGtkWidgetId::SpinButton);
     GtkStyle *style = gtk_widget_get_style(spinButton);
     gint size = pango_font_description_get_size (style->font_desc);
     gint arrow_size;
@@ -393,7 +733,7 @@ bool QGtkStylePrivate::isKDE4Session()
 void QGtkStylePrivate::applyCustomPaletteHash()
 {
     QPalette menuPal = gtkWidgetPalette("GtkMenu");
-    GdkColor gdkBg = gtk_widget_get_style(gtkWidget("GtkMenu"))->bg[GTK_STATE_NORMAL];
+    GdkColor gdkBg = gtk_widget_get_style(gtkWidget(QGtkWidgetId::Menu))->bg[GTK_STATE_NORMAL];
     QColor bgColor(gdkBg.red>>8, gdkBg.green>>8, gdkBg.blue>>8);
     menuPal.setBrush(QPalette::Base, bgColor);
     menuPal.setBrush(QPalette::Window, bgColor);
@@ -411,7 +751,7 @@ void QGtkStylePrivate::applyCustomPaletteHash()
 */
 GtkWidget* QGtkStylePrivate::getTextColorWidget() const
 {
-    return  gtkWidget("GtkEntry");
+    return  gtkWidget(QGtkWidgetId::Entry);
 }
 
 void QGtkStylePrivate::setupGtkWidget(GtkWidget* widget)
@@ -419,10 +759,17 @@ void QGtkStylePrivate::setupGtkWidget(GtkWidget* widget)
     if (Q_GTK_IS_WIDGET(widget)) {
         GtkWidget *protoLayout = gtkWidgetMap()->value("GtkContainer");
         if (!protoLayout) {
-            protoLayout = gtk_fixed_new();
-            gtk_container_add((GtkContainer*)(gtkWidgetMap()->value("GtkWindow")), protoLayout);
+            // Rebuilding the map for a new theme drops the entry, but not
+            // the layout, which later proto widgets still go into
+            GtkWidget *gtkWindow = gtkWidgetMap()->value("GtkWindow");
+            protoLayout = gtk_bin_get_child((GtkBin*)gtkWindow);
+            if (!protoLayout) {
+                protoLayout = gtk_fixed_new();
+                gtk_container_add((GtkContainer*)gtkWindow, protoLayout);
+            }
             QHashableLatin1Literal widgetPath = QHashableLatin1Literal::fromData(strdup("GtkContainer"));
             gtkWidgetMap()->insert(widgetPath, protoLayout);
+            widgetTableValid = false;
         }
         Q_ASSERT(protoLayout);
 
@@ -440,6 +787,7 @@ void QGtkStylePrivate::removeWidgetFromMap(const QHashableLatin1Literal &path)
         char* keyData = const_cast<char *>(it.key().data());
         map->erase(it);
         free(keyData);
+        widgetTableValid = false;
     }
 }
 
@@ -451,6 +799,7 @@ void QGtkStylePrivate::addWidgetToMap(GtkWidget *widget)
 
         removeWidgetFromMap(widgetPath);
         gtkWidgetMap()->insert(widgetPath, widget);
+        widgetTableValid = false;
 #ifdef DUMP_GTK_WIDGET_TREE
         qWarning("Inserted Gtk Widget: %s", widgetPath.data());
 #endif
@@ -490,7 +839,9 @@ QPalette QGtkStylePrivate::gtkWidgetPalette(const QHashableLatin1Literal &gtkWid
 void QGtkStyleUpdateScheduler::updateTheme()
 {
     static QString oldTheme(QLS("qt_not_set"));
-    QPixmapCache::clear();
+    QGtkPixmapCache::clear();
+    QGtkStylePrivate::clearStyleProperties();
+    QGtkStylePrivate::gtkPainter()->clearCaches();
 
     QFont font = QGtkStylePrivate::getThemeFont();
     if (QApplication::font() != font)
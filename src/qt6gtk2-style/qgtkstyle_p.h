@@ -37,6 +37,7 @@
 #include <QFont>
 #include <QFileDialog>
 #include <QCommonStyle>
+#include <QVariantMap>
 
 QT_BEGIN_NAMESPACE
 
@@ -99,6 +100,9 @@ public:
 
     void unpolish(QWidget *widget) override;
     void unpolish(QApplication *app) override;
+
+    // Cache and rendering statistics of the painter, see QGtkStats
+    Q_INVOKABLE QVariantMap statistics() const;
 };
 
 #endif //!defined(QT_NO_STYLE_QGTK)
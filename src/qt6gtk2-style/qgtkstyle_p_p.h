@@ -97,8 +97,100 @@ bool operator==(const QHashableLatin1Literal &l1, const QHashableLatin1Literal &
 inline bool operator!=(const QHashableLatin1Literal &l1, const QHashableLatin1Literal &l2) { return !operator==(l1, l2); }
 uint qHash(const QHashableLatin1Literal &key);
 
+// The proto widget paths the style asks for by name. They index a flat
+// table of widgets, so looking them up hashes no strings.
+enum class QGtkWidgetId
+{
+    Window,
+    Arrow,
+    Button,
+    CheckButton,
+    RadioButton,
+    ComboBox,
+    ComboBoxFrame,
+    ComboBoxToggleButton,
+    ComboBoxToggleButtonArrow,
+    ComboBoxToggleButtonHBoxArrow,
+    ComboBoxToggleButtonHBoxVSeparator,
+    ComboBoxEntry,
+    ComboBoxEntryEntry,
+    ComboBoxEntryToggleButton,
+    ComboBoxEntryToggleButtonArrow,
+    ComboBoxEntryToggleButtonHBoxArrow,
+    ComboBoxEntryToggleButtonHBoxVSeparator,
+    Entry,
+    Frame,
+    HButtonBox,
+    HScale,
+    VScale,
+    HScrollbar,
+    VScrollbar,
+    Menu,
+    MenuCheckMenuItem,
+    MenuMenuItem,
+    MenuSeparatorMenuItem,
+    MenuBar,
+    MenuBarMenuItem,
+    Notebook,
+    ProgressBar,
+    ScrolledWindow,
+    SpinButton,
+    Statusbar,
+    StatusbarFrame,
+    ToolButtonButton,
+    Toolbar,
+    ToolbarSeparatorToolItem,
+    TreeView,
+    TreeViewButton,
+    Count
+};
+
 QT_END_NAMESPACE
 
+// Style properties of a proto widget, as gtk_widget_style_get() gives
+// them. Properties the widget's class does not have keep their defaults.
+struct QGtkStyleProperties
+{
+    // GtkWidget
+    gboolean interiorFocus;
+    gint focusLineWidth;
+    gint focusPadding;
+    gboolean wideSeparators;
+    gint separatorHeight;
+    // GtkButton
+    gint childDisplacementX;
+    gint childDisplacementY;
+    bool hasInnerBorder;
+    GtkBorder innerBorder;
+    // GtkCheckButton, GtkCheckMenuItem
+    gint indicatorSize;
+    gint indicatorSpacing;
+    // GtkRange, GtkScale
+    gint sliderWidth;
+    gint sliderLength;
+    gint troughBorder;
+    gboolean troughSideDetails;
+    gboolean troughUnderSteppers;
+    gint stepperSize;
+    // GtkScrolledWindow
+    gint scrollbarSpacing;
+    gboolean scrollbarsWithinBevel;
+    // GtkMenu, GtkMenuItem
+    gint horizontalPadding;
+    gint horizontalOffset;
+    GtkShadowType selectedShadowType;
+    // GtkArrow, GtkMenuItem
+    gfloat arrowScaling;
+    // GtkComboBox
+    gboolean appearsAsList;
+    gint arrowSize;
+    // GtkToolbar, GtkMenuBar, GtkStatusbar
+    GtkShadowType shadowType;
+    // GtkButtonBox
+    gint childMinWidth;
+    gint childMinHeight;
+};
+
 typedef struct _XDisplay Display;
 
 QT_BEGIN_NAMESPACE
@@ -128,7 +220,22 @@ public:
 
     static QGtkPainter* gtkPainter(QPainter *painter = nullptr);
     static GtkWidget* gtkWidget(const QHashableLatin1Literal &path);
-    static GtkStyle* gtkStyle(const QHashableLatin1Literal &path = QHashableLatin1Literal("GtkWindow"));
+    static GtkStyle* gtkStyle(const QHashableLatin1Literal &path);
+    static inline GtkWidget* gtkWidget(QGtkWidgetId id)
+    {
+        if (!widgetTableValid)
+            updateWidgetTable();
+        if (GtkWidget *widget = widgetTable[int(id)])
+            return widget;
+        if (widgetMissing[int(id)])
+            return nullptr;
+        return createWidget(id);
+    }
+    static GtkStyle* gtkStyle(QGtkWidgetId id = QGtkWidgetId::Window);
+    static QHashableLatin1Literal widgetPath(QGtkWidgetId id);
+    // Read once per theme, the style-set handler drops them
+    static const QGtkStyleProperties &styleProperties(QGtkWidgetId id);
+    static void clearStyleProperties();
     static void gtkWidgetSetFocus(GtkWidget *widget, bool focus);
 
     virtual void initGtkMenu() const;
@@ -155,6 +262,8 @@ protected:
         cleanupGtkWidgets();
         delete widgetMap;
         widgetMap = nullptr;
+        widgetTableValid = false;
+        createdWidgetFamilies = 0;
     }
 
     static inline WidgetMap *gtkWidgetMap()
@@ -174,6 +283,8 @@ protected:
     static void addAllSubWidgets(GtkWidget *widget, gpointer v = nullptr);
     static void addWidget(GtkWidget *widget);
     static void removeWidgetFromMap(const QHashableLatin1Literal &path);
+    static bool createWidgetFamily(const QHashableLatin1Literal &path);
+    static GtkWidget* createWidget(QGtkWidgetId id);
 
     virtual void init();
 
@@ -189,6 +300,13 @@ protected:
 private:
     static QList<QGtkStylePrivate *> instances;
     static WidgetMap *widgetMap;
+    static GtkWidget *widgetTable[int(QGtkWidgetId::Count)];
+    static bool widgetTableValid; // cleared whenever widgetMap changes
+    static bool widgetMissing[int(QGtkWidgetId::Count)]; // not made by createWidget(), until widgetMap changes
+    static void updateWidgetTable();
+    static quint32 createdWidgetFamilies;
+    static QGtkStyleProperties widgetProperties[int(QGtkWidgetId::Count)];
+    static GtkWidget *propertiesSources[int(QGtkWidgetId::Count)]; // widgets they were read from
     friend class QGtkStyleUpdateScheduler;
 };
 
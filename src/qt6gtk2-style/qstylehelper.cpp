@@ -20,7 +20,6 @@
 
 #include <QStyleOption>
 #include <QPainter>
-#include <QPixmapCache>
 #include <private/qmath_p.h>
 #include <private/qstyle_p.h>
 #include <QtMath>
@@ -29,6 +28,7 @@
 #include <QWindow>
 
 #include "qstylehelper_p.h"
+#include "qgtkpixmapcache_p.h"
 #include <QStringBuilder>
 
 QT_BEGIN_NAMESPACE
@@ -219,7 +219,7 @@ void drawDial(const QStyleOptionSlider *option, QPainter *painter)
     }
 
     // Cache dial background
-    BEGIN_STYLE_PIXMAPCACHE(QString::fromLatin1("qdial"));
+    BEGIN_GTK_STYLE_PIXMAPCACHE(QString::fromLatin1("qdial"));
     p->setRenderHint(QPainter::Antialiasing);
 
     const qreal d_ = r / 6;
@@ -279,7 +279,7 @@ void drawDial(const QStyleOptionSlider *option, QPainter *painter)
         p->drawEllipse(br.adjusted(-1, -1, 1, 1));
     }
 
-    END_STYLE_PIXMAPCACHE
+    END_GTK_STYLE_PIXMAPCACHE
 
     QPointF dp = calcRadialPos(option, qreal(0.70));
     buttonColor = buttonColor.lighter(104);
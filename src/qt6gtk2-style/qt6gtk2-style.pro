@@ -8,19 +8,27 @@ DEFINES += QT_NO_ANIMATION
 
 # Input
 HEADERS += qgtk2painter_p.h \
+           qgtkdiskcache_p.h \
            qgtkglobal_p.h \
            qgtkpainter_p.h \
+           qgtkpixmapcache_p.h \
+           qgtkrendertheme_p.h \
+           qgtksharedcache_p.h \
+           qgtkshmreadback_p.h \
+           qgtkstats_p.h \
            qgtkstyle_p.h \
            qgtkstyle_p_p.h \
     qstylehelper_p.h
-SOURCES += qgtk2painter.cpp qgtkpainter.cpp qgtkstyle.cpp qgtkstyle_p.cpp \
+SOURCES += qgtk2painter.cpp qgtkdiskcache.cpp qgtkpainter.cpp qgtkpixmapcache.cpp qgtkrendertheme.cpp qgtksharedcache.cpp qgtkshmreadback.cpp qgtkstats.cpp qgtkstyle.cpp qgtkstyle_p.cpp \
     plugin.cpp \
     qstylehelper.cpp
 
 CONFIG += plugin \
           link_pkgconfig \
 
-PKGCONFIG += gtk+-2.0 x11
+PKGCONFIG += gtk+-2.0 x11 xext
+# shm_open() lives in librt before glibc 2.34
+LIBS += -lrt
 
 target.path = $$PLUGINDIR/styles
 INSTALLS += target
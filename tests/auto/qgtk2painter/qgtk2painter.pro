@@ -0,0 +1,40 @@
+include(../../../qt6gtk2.pri)
+
+TEMPLATE = app
+TARGET = tst_qgtk2painter
+QT += testlib core-private gui-private widgets-private
+CONFIG += testcase \
+          link_pkgconfig \
+
+DEFINES += QT_NO_ANIMATION SRCDIR=\\\"$$PWD/\\\"
+PKGCONFIG += gtk+-2.0 x11 xext
+LIBS += -lrt
+
+# The style is built in, so the test can drive the painter directly
+STYLEDIR = ../../../src/qt6gtk2-style
+INCLUDEPATH += $$STYLEDIR
+
+HEADERS += $$STYLEDIR/qgtk2painter_p.h \
+           $$STYLEDIR/qgtkdiskcache_p.h \
+           $$STYLEDIR/qgtkglobal_p.h \
+           $$STYLEDIR/qgtkpainter_p.h \
+           $$STYLEDIR/qgtkpixmapcache_p.h \
+           $$STYLEDIR/qgtkrendertheme_p.h \
+           $$STYLEDIR/qgtksharedcache_p.h \
+           $$STYLEDIR/qgtkshmreadback_p.h \
+           $$STYLEDIR/qgtkstats_p.h \
+           $$STYLEDIR/qgtkstyle_p.h \
+           $$STYLEDIR/qgtkstyle_p_p.h \
+           $$STYLEDIR/qstylehelper_p.h
+SOURCES += tst_qgtk2painter.cpp \
+           $$STYLEDIR/qgtk2painter.cpp \
+           $$STYLEDIR/qgtkdiskcache.cpp \
+           $$STYLEDIR/qgtkpainter.cpp \
+           $$STYLEDIR/qgtkpixmapcache.cpp \
+           $$STYLEDIR/qgtkrendertheme.cpp \
+           $$STYLEDIR/qgtksharedcache.cpp \
+           $$STYLEDIR/qgtkshmreadback.cpp \
+           $$STYLEDIR/qgtkstats.cpp \
+           $$STYLEDIR/qgtkstyle.cpp \
+           $$STYLEDIR/qgtkstyle_p.cpp \
+           $$STYLEDIR/qstylehelper.cpp
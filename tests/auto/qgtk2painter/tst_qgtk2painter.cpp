@@ -0,0 +1,258 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+
+#include <QtTest>
+#include <QApplication>
+#include <QImage>
+#include <QPainter>
+#include "qgtkstyle_p.h"
+#include "qgtkstyle_p_p.h"
+#include "qgtk2painter_p.h"
+
+// Elements rendered through the ARGB visual must look the same as the two
+// pass renders they replace, on the theme of the style benchmark. Engines
+// that draw some primitives with GCs leave their alpha unset; the painter
+// has to notice and fall back for those elements. Needs an X server with
+// an ARGB visual, such as Xvfb.
+class tst_QGtk2Painter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void initMain();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void argbMatchesTwoPass_data();
+    void argbMatchesTwoPass();
+
+private:
+    enum Element
+    {
+        Box,
+        FlatBox,
+        Shadow,
+        Focus,
+        Hline,
+        Vline,
+        Arrow,
+        Slider,
+        Extension,
+        Option,
+        Checkbox
+    };
+
+    static QImage paint(QGtk2Painter *painter, Element element, const QSize &size, GtkStateType state);
+
+    QStyle *m_style = nullptr;
+    QGtk2Painter *m_argb = nullptr;
+    QGtk2Painter *m_twoPass = nullptr;
+};
+
+void tst_QGtk2Painter::initMain()
+{
+    qputenv("GTK2_RC_FILES", SRCDIR "../../benchmarks/qgtkstyle/theme/gtk-2.0/gtkrc");
+    qputenv("QT6GTK2_DISK_CACHE", "0");
+    qunsetenv("QT6GTK2_SHARED_CACHE");
+    qunsetenv("QT6GTK2_WARMUP");
+}
+
+void tst_QGtk2Painter::initTestCase()
+{
+    m_style = new QGtkStyle;
+    if (!QGtkStylePrivate::isThemeAvailable())
+        QSKIP("GTK+ could not load the theme");
+    if (!gdk_screen_get_rgba_colormap(gdk_screen_get_default()))
+        QSKIP("The X server has no ARGB visual");
+
+    // Each painter reads the switch when it renders for the first time
+    qputenv("QT6GTK2_ARGB_RENDERING", "1");
+    m_argb = new QGtk2Painter;
+    paint(m_argb, Box, QSize(16, 16), GTK_STATE_NORMAL);
+    qputenv("QT6GTK2_ARGB_RENDERING", "0");
+    m_twoPass = new QGtk2Painter;
+    paint(m_twoPass, Box, QSize(16, 16), GTK_STATE_NORMAL);
+    qunsetenv("QT6GTK2_ARGB_RENDERING");
+}
+
+void tst_QGtk2Painter::cleanupTestCase()
+{
+    delete m_argb;
+    m_argb = nullptr;
+    delete m_twoPass;
+    m_twoPass = nullptr;
+    delete m_style;
+    m_style = nullptr;
+}
+
+QImage tst_QGtk2Painter::paint(QGtk2Painter *painter, Element element, const QSize &size, GtkStateType state)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter p(&image);
+    painter->reset(&p);
+    // Both painters would share the pixmap cache
+    painter->setUsePixmapCache(false);
+
+    const QRect rect(QPoint(0, 0), size);
+    const GtkShadowType shadow = state == GTK_STATE_ACTIVE ? GTK_SHADOW_IN : GTK_SHADOW_OUT;
+    switch (element) {
+    case Box: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Button);
+        painter->paintBox(widget, "button", rect, state, shadow, gtk_widget_get_style(widget));
+        break;
+    }
+    case FlatBox: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Entry);
+        painter->paintFlatBox(widget, "entry_bg", rect, state, GTK_SHADOW_NONE, gtk_widget_get_style(widget));
+        break;
+    }
+    case Shadow: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Entry);
+        painter->paintShadow(widget, "entry", rect, state, GTK_SHADOW_IN, gtk_widget_get_style(widget));
+        break;
+    }
+    case Focus: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Button);
+        painter->paintFocus(widget, "button", rect, state, gtk_widget_get_style(widget));
+        break;
+    }
+    case Hline: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Window);
+        painter->paintHline(widget, "hseparator", rect, state, gtk_widget_get_style(widget),
+                            0, size.width(), size.height() / 2);
+        break;
+    }
+    case Vline: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Window);
+        painter->paintVline(widget, "vseparator", rect, state, gtk_widget_get_style(widget),
+                            0, size.height(), size.width() / 2);
+        break;
+    }
+    case Arrow: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Arrow);
+        painter->paintArrow(widget, "arrow", rect, GTK_ARROW_DOWN, state, GTK_SHADOW_NONE, true,
+                            gtk_widget_get_style(widget));
+        break;
+    }
+    case Slider: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::HScrollbar);
+        painter->paintSlider(widget, "slider", rect, state, shadow, gtk_widget_get_style(widget),
+                             GTK_ORIENTATION_HORIZONTAL);
+        break;
+    }
+    case Extension: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Notebook);
+        painter->paintExtention(widget, "tab", rect, state, GTK_SHADOW_OUT, GTK_POS_BOTTOM,
+                                gtk_widget_get_style(widget));
+        break;
+    }
+    case Option: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::CheckButton);
+        painter->paintOption(widget, rect, state, shadow, gtk_widget_get_style(widget), "radiobutton");
+        break;
+    }
+    case Checkbox: {
+        GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::CheckButton);
+        painter->paintCheckbox(widget, rect, state, shadow, gtk_widget_get_style(widget), "checkbutton");
+        break;
+    }
+    }
+    p.end();
+    painter->reset(nullptr);
+    return image;
+}
+
+void tst_QGtk2Painter::argbMatchesTwoPass_data()
+{
+    QTest::addColumn<int>("element");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("state");
+
+    static const struct {
+        const char *name;
+        Element element;
+    } elements[] = {
+        { "box", Box },
+        { "flatbox", FlatBox },
+        { "shadow", Shadow },
+        { "focus", Focus },
+        { "hline", Hline },
+        { "vline", Vline },
+        { "arrow", Arrow },
+        { "slider", Slider },
+        { "extension", Extension },
+        { "option", Option },
+        { "checkbox", Checkbox }
+    };
+    // The largest size is composed from nine slices
+    static const QSize sizes[] = { QSize(16, 16), QSize(100, 28), QSize(320, 200) };
+    static const struct {
+        const char *name;
+        GtkStateType state;
+    } states[] = {
+        { "normal", GTK_STATE_NORMAL },
+        { "prelight", GTK_STATE_PRELIGHT },
+        { "active", GTK_STATE_ACTIVE },
+        { "insensitive", GTK_STATE_INSENSITIVE }
+    };
+
+    for (const auto &element : elements) {
+        for (const QSize &size : sizes) {
+            for (const auto &state : states) {
+                QTest::addRow("%s-%dx%d-%s", element.name, size.width(), size.height(), state.name)
+                        << int(element.element) << size << int(state.state);
+            }
+        }
+    }
+}
+
+void tst_QGtk2Painter::argbMatchesTwoPass()
+{
+    QFETCH(int, element);
+    QFETCH(QSize, size);
+    QFETCH(int, state);
+
+    const QImage argb = paint(m_argb, Element(element), size, GtkStateType(state));
+    const QImage twoPass = paint(m_twoPass, Element(element), size, GtkStateType(state));
+
+    // The two pass render recovers alpha from a black and a white render,
+    // which rounds
+    const int tolerance = 2;
+    for (int y = 0; y < size.height(); ++y) {
+        const QRgb *argbLine = reinterpret_cast<const QRgb *>(argb.constScanLine(y));
+        const QRgb *twoPassLine = reinterpret_cast<const QRgb *>(twoPass.constScanLine(y));
+        for (int x = 0; x < size.width(); ++x) {
+            if (qAbs(qAlpha(argbLine[x]) - qAlpha(twoPassLine[x])) > tolerance
+                    || qAbs(qRed(argbLine[x]) - qRed(twoPassLine[x])) > tolerance
+                    || qAbs(qGreen(argbLine[x]) - qGreen(twoPassLine[x])) > tolerance
+                    || qAbs(qBlue(argbLine[x]) - qBlue(twoPassLine[x])) > tolerance) {
+                QFAIL(qPrintable(QStringLiteral("pixel %1,%2 is %3 through ARGB and %4 in two passes")
+                                 .arg(x).arg(y).arg(argbLine[x], 8, 16, QLatin1Char('0'))
+                                 .arg(twoPassLine[x], 8, 16, QLatin1Char('0'))));
+            }
+        }
+    }
+}
+
+QTEST_MAIN(tst_QGtk2Painter)
+
+#include "tst_qgtk2painter.moc"
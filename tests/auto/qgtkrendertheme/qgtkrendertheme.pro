@@ -0,0 +1,17 @@
+include(../../../qt6gtk2.pri)
+
+TEMPLATE = app
+TARGET = tst_qgtkrendertheme
+QT += testlib core-private
+CONFIG += testcase \
+          link_pkgconfig \
+
+PKGCONFIG += gtk+-2.0
+
+STYLEDIR = ../../../src/qt6gtk2-style
+INCLUDEPATH += $$STYLEDIR
+
+# The kernels are built in, the test does not load the plugin
+HEADERS += $$STYLEDIR/qgtkrendertheme_p.h
+SOURCES += tst_qgtkrendertheme.cpp \
+           $$STYLEDIR/qgtkrendertheme.cpp
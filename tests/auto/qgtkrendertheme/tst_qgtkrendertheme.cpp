@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include <QtTest>
+#include <QRandomGenerator>
+#include <cstring>
+#include "qgtkrendertheme_p.h"
+
+// Every SIMD kernel must give the same bytes as the scalar one, for
+// any pixel count and for channels where white is brighter than black.
+class tst_QGtkRenderTheme : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void kernels_data();
+    void kernels();
+    void resolved();
+};
+
+void tst_QGtkRenderTheme::kernels_data()
+{
+    QTest::addColumn<int>("kernel");
+    QTest::addColumn<int>("pixelCount");
+    QTest::addColumn<bool>("alpha");
+
+    const QList<QGtkRenderThemeKernel> kernels = qt_gtk_render_theme_kernels();
+    if (kernels.size() == 1)
+        QSKIP("No SIMD kernel for this CPU");
+
+    static const int pixelCounts[] = { 1, 3, 5, 7, 9, 15, 17, 31, 33, 63, 65, 127, 257, 1023 };
+    for (int i = 1; i < kernels.size(); ++i) {
+        for (int pixelCount : pixelCounts) {
+            for (bool alpha : { false, true }) {
+                QTest::addRow("%s-%d-%s", kernels.at(i).name, pixelCount, alpha ? "alpha" : "opaque")
+                        << i << pixelCount << alpha;
+            }
+        }
+    }
+}
+
+void tst_QGtkRenderTheme::kernels()
+{
+    QFETCH(int, kernel);
+    QFETCH(int, pixelCount);
+    QFETCH(bool, alpha);
+
+    const QGtkRenderThemeKernel simd = qt_gtk_render_theme_kernels().at(kernel);
+    QRandomGenerator generator(quint32(pixelCount * 2 + alpha));
+    for (int round = 0; round < 16; ++round) {
+        QByteArray black(pixelCount * 4, Qt::Uninitialized);
+        QByteArray white(pixelCount * 4, Qt::Uninitialized);
+        generator.fillRange(reinterpret_cast<quint32 *>(black.data()), pixelCount);
+        generator.fillRange(reinterpret_cast<quint32 *>(white.data()), pixelCount);
+        QByteArray expected = black;
+
+        qt_gtk_render_theme_generic(reinterpret_cast<uchar *>(expected.data()),
+                                    alpha ? reinterpret_cast<const uchar *>(white.constData()) : nullptr, pixelCount);
+        simd.function(reinterpret_cast<uchar *>(black.data()),
+                      alpha ? reinterpret_cast<const uchar *>(white.constData()) : nullptr, pixelCount);
+
+        QVERIFY(memcmp(black.constData(), expected.constData(), size_t(pixelCount) * 4) == 0);
+    }
+}
+
+void tst_QGtkRenderTheme::resolved()
+{
+    const QGtkRenderThemeFunction function = qt_gtk_resolve_render_theme();
+    bool found = false;
+    for (const QGtkRenderThemeKernel &kernel : qt_gtk_render_theme_kernels())
+        found |= kernel.function == function;
+    QVERIFY(found);
+}
+
+QTEST_APPLESS_MAIN(tst_QGtkRenderTheme)
+
+#include "tst_qgtkrendertheme.moc"
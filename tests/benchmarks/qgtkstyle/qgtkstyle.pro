@@ -0,0 +1,41 @@
+include(../../../qt6gtk2.pri)
+
+TEMPLATE = app
+TARGET = tst_qgtkstyle_bench
+QT += testlib core-private gui-private widgets-private
+CONFIG += benchmark \
+          testcase \
+          link_pkgconfig \
+
+DEFINES += QT_NO_ANIMATION SRCDIR=\\\"$$PWD/\\\"
+PKGCONFIG += gtk+-2.0 x11 xext
+LIBS += -lrt
+
+# The style is built in, so its caches can be cleared between runs
+STYLEDIR = ../../../src/qt6gtk2-style
+INCLUDEPATH += $$STYLEDIR
+
+HEADERS += $$STYLEDIR/qgtk2painter_p.h \
+           $$STYLEDIR/qgtkdiskcache_p.h \
+           $$STYLEDIR/qgtkglobal_p.h \
+           $$STYLEDIR/qgtkpainter_p.h \
+           $$STYLEDIR/qgtkpixmapcache_p.h \
+           $$STYLEDIR/qgtkrendertheme_p.h \
+           $$STYLEDIR/qgtksharedcache_p.h \
+           $$STYLEDIR/qgtkshmreadback_p.h \
+           $$STYLEDIR/qgtkstats_p.h \
+           $$STYLEDIR/qgtkstyle_p.h \
+           $$STYLEDIR/qgtkstyle_p_p.h \
+           $$STYLEDIR/qstylehelper_p.h
+SOURCES += tst_qgtkstyle_bench.cpp \
+           $$STYLEDIR/qgtk2painter.cpp \
+           $$STYLEDIR/qgtkdiskcache.cpp \
+           $$STYLEDIR/qgtkpainter.cpp \
+           $$STYLEDIR/qgtkpixmapcache.cpp \
+           $$STYLEDIR/qgtkrendertheme.cpp \
+           $$STYLEDIR/qgtksharedcache.cpp \
+           $$STYLEDIR/qgtkshmreadback.cpp \
+           $$STYLEDIR/qgtkstats.cpp \
+           $$STYLEDIR/qgtkstyle.cpp \
+           $$STYLEDIR/qgtkstyle_p.cpp \
+           $$STYLEDIR/qstylehelper.cpp
@@ -0,0 +1,610 @@
+/***************************************************************************
+ *   Copyright (C) 2016-2024 Ilya Kotov, forkotov02@ya.ru                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include <QtTest>
+#include <QAbstractSpinBox>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFrame>
+#include <QImage>
+#include <QPainter>
+#include <QProcess>
+#include <QSlider>
+#include <QStyleOption>
+#include <algorithm>
+#include <cstdio>
+#include "qgtkstyle_p.h"
+#include "qgtkstyle_p_p.h"
+#include "qgtkpainter_p.h"
+#include "qgtkpixmapcache_p.h"
+
+// Times every primitive, control and complex control of the style for a
+// few sizes, states and directions, against the theme next to this file.
+// A cold run clears the caches before each element, so every paint asks
+// GTK+; a warm run repeats paints that all hit the cache. hitPath times
+// the cache lookup alone. startup times making the style and its first
+// paint in fresh processes, with the proto widgets made when needed and
+// all up front. Results are in nanoseconds per paint, lookup or startup.
+// Needs an X server, such as Xvfb.
+class tst_QGtkStyleBench : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void initMain();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void drawPrimitive_data();
+    void drawPrimitive();
+    void drawControl_data();
+    void drawControl();
+    void drawComplexControl_data();
+    void drawComplexControl();
+    void hitPath_data();
+    void hitPath();
+    void startup_data();
+    void startup();
+    void startupChild();
+
+private:
+    void addRows();
+    template <typename Draw>
+    void run(int count, const Draw &draw);
+
+    QStyle *m_style = nullptr;
+};
+
+namespace {
+
+// Options of every type the elements look for, filled in for one
+// rect, state and direction
+class QBenchOptions
+{
+public:
+    QBenchOptions(const QRect &rect, QStyle::State state, Qt::LayoutDirection direction);
+
+    const QStyleOption *primitive(QStyle::PrimitiveElement element) const;
+    const QStyleOption *control(QStyle::ControlElement element) const;
+    const QStyleOptionComplex *complex(QStyle::ComplexControl control) const;
+
+private:
+    void init(QStyleOption &option) const;
+
+    QRect m_rect;
+    QStyle::State m_state;
+    Qt::LayoutDirection m_direction;
+
+    QStyleOption plain;
+    QStyleOptionFocusRect focusRect;
+    QStyleOptionFrame frame;
+    QStyleOptionTabWidgetFrame tabWidgetFrame;
+    QStyleOptionTabBarBase tabBarBase;
+    QStyleOptionHeader header;
+    QStyleOptionViewItem viewItem;
+    QStyleOptionButton button;
+    QStyleOptionTab tab;
+    QStyleOptionToolBox toolBox;
+    QStyleOptionProgressBar progressBar;
+    QStyleOptionMenuItem menuItem;
+    QStyleOptionDockWidget dockWidget;
+    QStyleOptionRubberBand rubberBand;
+    QStyleOptionToolBar toolBar;
+    QStyleOptionSizeGrip sizeGrip;
+    QStyleOptionComplex complexPlain;
+    QStyleOptionSlider slider;
+    QStyleOptionSpinBox spinBox;
+    QStyleOptionComboBox comboBox;
+    QStyleOptionToolButton toolButton;
+    QStyleOptionTitleBar titleBar;
+    QStyleOptionGroupBox groupBox;
+};
+
+QBenchOptions::QBenchOptions(const QRect &rect, QStyle::State state, Qt::LayoutDirection direction)
+    : m_rect(rect), m_state(state), m_direction(direction)
+{
+    const QString text = QStringLiteral("Text");
+    const Qt::Orientation orientation = rect.width() >= rect.height() ? Qt::Horizontal : Qt::Vertical;
+
+    init(plain);
+    init(focusRect);
+    init(frame);
+    frame.lineWidth = 1;
+    frame.frameShape = QFrame::StyledPanel;
+    init(tabWidgetFrame);
+    tabWidgetFrame.lineWidth = 1;
+    init(tabBarBase);
+    tabBarBase.tabBarRect = rect;
+    init(header);
+    header.text = text;
+    header.sortIndicator = QStyleOptionHeader::SortDown;
+    init(viewItem);
+    viewItem.text = text;
+    viewItem.features = QStyleOptionViewItem::HasDisplay;
+    init(button);
+    button.text = text;
+    init(tab);
+    tab.text = text;
+    init(toolBox);
+    toolBox.text = text;
+    init(progressBar);
+    progressBar.minimum = 0;
+    progressBar.maximum = 100;
+    progressBar.progress = 40;
+    progressBar.text = text;
+    progressBar.textVisible = true;
+    progressBar.state |= orientation == Qt::Horizontal ? QStyle::State_Horizontal : QStyle::State_None;
+    init(menuItem);
+    menuItem.text = text;
+    menuItem.menuItemType = QStyleOptionMenuItem::Normal;
+    menuItem.checkType = QStyleOptionMenuItem::NonExclusive;
+    menuItem.maxIconWidth = 16;
+    menuItem.menuRect = rect;
+    init(dockWidget);
+    dockWidget.title = text;
+    dockWidget.closable = true;
+    init(rubberBand);
+    init(toolBar);
+    init(sizeGrip);
+
+    init(complexPlain);
+    complexPlain.subControls = QStyle::SC_All;
+    init(slider);
+    slider.subControls = QStyle::SC_All;
+    slider.orientation = orientation;
+    slider.minimum = 0;
+    slider.maximum = 100;
+    slider.sliderPosition = slider.sliderValue = 30;
+    slider.singleStep = 1;
+    slider.pageStep = 10;
+    slider.tickPosition = QSlider::TicksBelow;
+    slider.state |= orientation == Qt::Horizontal ? QStyle::State_Horizontal : QStyle::State_None;
+    init(spinBox);
+    spinBox.subControls = QStyle::SC_All;
+    spinBox.stepEnabled = QAbstractSpinBox::StepUpEnabled | QAbstractSpinBox::StepDownEnabled;
+    init(comboBox);
+    comboBox.subControls = QStyle::SC_All;
+    comboBox.currentText = text;
+    init(toolButton);
+    toolButton.subControls = QStyle::SC_All;
+    toolButton.text = text;
+    toolButton.features = QStyleOptionToolButton::MenuButtonPopup;
+    toolButton.toolButtonStyle = Qt::ToolButtonTextOnly;
+    init(titleBar);
+    titleBar.subControls = QStyle::SC_All;
+    titleBar.text = text;
+    titleBar.titleBarFlags = Qt::Window | Qt::WindowTitleHint | Qt::WindowSystemMenuHint
+            | Qt::WindowMinMaxButtonsHint | Qt::WindowCloseButtonHint;
+    init(groupBox);
+    groupBox.subControls = QStyle::SC_All;
+    groupBox.text = text;
+}
+
+void QBenchOptions::init(QStyleOption &option) const
+{
+    option.rect = m_rect;
+    option.state = m_state;
+    option.direction = m_direction;
+    option.palette = QApplication::palette();
+    option.fontMetrics = QFontMetrics(QApplication::font());
+}
+
+const QStyleOption *QBenchOptions::primitive(QStyle::PrimitiveElement element) const
+{
+    switch (element) {
+    case QStyle::PE_FrameFocusRect:
+        return &focusRect;
+    case QStyle::PE_Frame:
+    case QStyle::PE_FrameDockWidget:
+    case QStyle::PE_FrameGroupBox:
+    case QStyle::PE_FrameLineEdit:
+    case QStyle::PE_FrameMenu:
+    case QStyle::PE_FrameStatusBarItem:
+    case QStyle::PE_FrameWindow:
+    case QStyle::PE_PanelLineEdit:
+        return &frame;
+    case QStyle::PE_FrameTabWidget:
+        return &tabWidgetFrame;
+    case QStyle::PE_FrameTabBarBase:
+        return &tabBarBase;
+    case QStyle::PE_IndicatorHeaderArrow:
+        return &header;
+    case QStyle::PE_PanelItemViewItem:
+    case QStyle::PE_PanelItemViewRow:
+        return &viewItem;
+    case QStyle::PE_FrameDefaultButton:
+    case QStyle::PE_FrameButtonBevel:
+    case QStyle::PE_PanelButtonBevel:
+    case QStyle::PE_PanelButtonCommand:
+        return &button;
+    case QStyle::PE_PanelToolBar:
+        return &toolBar;
+    default:
+        return &plain;
+    }
+}
+
+const QStyleOption *QBenchOptions::control(QStyle::ControlElement element) const
+{
+    switch (element) {
+    case QStyle::CE_PushButton:
+    case QStyle::CE_PushButtonBevel:
+    case QStyle::CE_PushButtonLabel:
+    case QStyle::CE_CheckBox:
+    case QStyle::CE_CheckBoxLabel:
+    case QStyle::CE_RadioButton:
+    case QStyle::CE_RadioButtonLabel:
+        return &button;
+    case QStyle::CE_TabBarTab:
+    case QStyle::CE_TabBarTabShape:
+    case QStyle::CE_TabBarTabLabel:
+        return &tab;
+    case QStyle::CE_ProgressBar:
+    case QStyle::CE_ProgressBarGroove:
+    case QStyle::CE_ProgressBarContents:
+    case QStyle::CE_ProgressBarLabel:
+        return &progressBar;
+    case QStyle::CE_MenuItem:
+    case QStyle::CE_MenuScroller:
+    case QStyle::CE_MenuVMargin:
+    case QStyle::CE_MenuHMargin:
+    case QStyle::CE_MenuTearoff:
+    case QStyle::CE_MenuEmptyArea:
+    case QStyle::CE_MenuBarItem:
+    case QStyle::CE_MenuBarEmptyArea:
+        return &menuItem;
+    case QStyle::CE_ToolButtonLabel:
+        return &toolButton;
+    case QStyle::CE_Header:
+    case QStyle::CE_HeaderSection:
+    case QStyle::CE_HeaderLabel:
+    case QStyle::CE_HeaderEmptyArea:
+        return &header;
+    case QStyle::CE_ToolBoxTab:
+    case QStyle::CE_ToolBoxTabShape:
+    case QStyle::CE_ToolBoxTabLabel:
+        return &toolBox;
+    case QStyle::CE_SizeGrip:
+        return &sizeGrip;
+    case QStyle::CE_RubberBand:
+        return &rubberBand;
+    case QStyle::CE_DockWidgetTitle:
+        return &dockWidget;
+    case QStyle::CE_ScrollBarAddLine:
+    case QStyle::CE_ScrollBarSubLine:
+    case QStyle::CE_ScrollBarAddPage:
+    case QStyle::CE_ScrollBarSubPage:
+    case QStyle::CE_ScrollBarSlider:
+    case QStyle::CE_ScrollBarFirst:
+    case QStyle::CE_ScrollBarLast:
+        return &slider;
+    case QStyle::CE_ComboBoxLabel:
+        return &comboBox;
+    case QStyle::CE_ToolBar:
+        return &toolBar;
+    case QStyle::CE_ItemViewItem:
+        return &viewItem;
+    case QStyle::CE_ShapedFrame:
+        return &frame;
+    default:
+        return &plain;
+    }
+}
+
+const QStyleOptionComplex *QBenchOptions::complex(QStyle::ComplexControl control) const
+{
+    switch (control) {
+    case QStyle::CC_SpinBox:
+        return &spinBox;
+    case QStyle::CC_ComboBox:
+        return &comboBox;
+    case QStyle::CC_ScrollBar:
+    case QStyle::CC_Slider:
+    case QStyle::CC_Dial:
+        return &slider;
+    case QStyle::CC_ToolButton:
+        return &toolButton;
+    case QStyle::CC_TitleBar:
+        return &titleBar;
+    case QStyle::CC_GroupBox:
+        return &groupBox;
+    default:
+        return &complexPlain;
+    }
+}
+
+}
+
+void tst_QGtkStyleBench::initMain()
+{
+    // The theme of this benchmark only, and no renders of earlier runs
+    qputenv("GTK2_RC_FILES", SRCDIR "theme/gtk-2.0/gtkrc");
+    qputenv("QT6GTK2_DISK_CACHE", "0");
+    qunsetenv("QT6GTK2_SHARED_CACHE");
+    qunsetenv("QT6GTK2_WARMUP");
+}
+
+void tst_QGtkStyleBench::initTestCase()
+{
+    // startupChild() makes its own style
+    if (qEnvironmentVariableIsSet("QT6GTK2_BENCH_STARTUP"))
+        return;
+    m_style = new QGtkStyle;
+    if (!QGtkStylePrivate::isThemeAvailable())
+        QSKIP("GTK+ could not load the theme");
+}
+
+void tst_QGtkStyleBench::cleanupTestCase()
+{
+    delete m_style;
+    m_style = nullptr;
+}
+
+void tst_QGtkStyleBench::addRows()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("state");
+    QTest::addColumn<Qt::LayoutDirection>("direction");
+    QTest::addColumn<bool>("cold");
+
+    static const QSize sizes[] = { QSize(16, 16), QSize(100, 28), QSize(320, 200) };
+    static const struct {
+        const char *name;
+        QStyle::State state;
+    } states[] = {
+        { "normal", QStyle::State_Enabled | QStyle::State_Active },
+        { "hover", QStyle::State_Enabled | QStyle::State_Active | QStyle::State_MouseOver },
+        { "pressed", QStyle::State_Enabled | QStyle::State_Active | QStyle::State_Sunken | QStyle::State_On },
+        { "focus", QStyle::State_Enabled | QStyle::State_Active | QStyle::State_HasFocus },
+        { "disabled", QStyle::State_Active }
+    };
+
+    for (const QSize &size : sizes) {
+        for (const auto &state : states) {
+            for (Qt::LayoutDirection direction : { Qt::LeftToRight, Qt::RightToLeft }) {
+                for (bool cold : { true, false }) {
+                    QTest::addRow("%dx%d-%s-%s-%s", size.width(), size.height(), state.name,
+                                  direction == Qt::LeftToRight ? "ltr" : "rtl", cold ? "cold" : "warm")
+                            << size << int(state.state) << direction << cold;
+                }
+            }
+        }
+    }
+}
+
+// Paints elements 0 to count - 1 with draw(painter, element, options)
+// and reports the time per paint. A cold run clears the caches before
+// every paint, a warm run paints everything once before timing.
+template <typename Draw>
+void tst_QGtkStyleBench::run(int count, const Draw &draw)
+{
+    QFETCH(QSize, size);
+    QFETCH(int, state);
+    QFETCH(Qt::LayoutDirection, direction);
+    QFETCH(bool, cold);
+
+    const QBenchOptions options(QRect(QPoint(0, 0), size), QStyle::State(state), direction);
+    QImage canvas(size, QImage::Format_ARGB32_Premultiplied);
+    canvas.fill(Qt::transparent);
+    QPainter painter(&canvas);
+
+    const int rounds = cold ? 2 : 20;
+    if (!cold) {
+        for (int element = 0; element < count; ++element)
+            draw(&painter, element, options);
+    }
+
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    qint64 paints = 0;
+    for (int round = 0; round < rounds; ++round) {
+        for (int element = 0; element < count; ++element) {
+            if (cold) {
+                QGtkPixmapCache::clear();
+                QGtkStylePrivate::gtkPainter()->clearCaches();
+            }
+            timer.start();
+            draw(&painter, element, options);
+            nsecs += timer.nsecsElapsed();
+            ++paints;
+        }
+    }
+    QTest::setBenchmarkResult(qreal(nsecs) / paints, QTest::WalltimeNanoseconds);
+}
+
+void tst_QGtkStyleBench::drawPrimitive_data()
+{
+    addRows();
+}
+
+void tst_QGtkStyleBench::drawPrimitive()
+{
+    run(QStyle::PE_IndicatorTabTearRight + 1, [this](QPainter *painter, int element, const QBenchOptions &options) {
+        const QStyle::PrimitiveElement pe = QStyle::PrimitiveElement(element);
+        m_style->drawPrimitive(pe, options.primitive(pe), painter, nullptr);
+    });
+}
+
+void tst_QGtkStyleBench::drawControl_data()
+{
+    addRows();
+}
+
+void tst_QGtkStyleBench::drawControl()
+{
+    run(QStyle::CE_ShapedFrame + 1, [this](QPainter *painter, int element, const QBenchOptions &options) {
+        const QStyle::ControlElement ce = QStyle::ControlElement(element);
+        m_style->drawControl(ce, options.control(ce), painter, nullptr);
+    });
+}
+
+void tst_QGtkStyleBench::drawComplexControl_data()
+{
+    addRows();
+}
+
+void tst_QGtkStyleBench::drawComplexControl()
+{
+    run(QStyle::CC_MdiControls + 1, [this](QPainter *painter, int element, const QBenchOptions &options) {
+        const QStyle::ComplexControl cc = QStyle::ComplexControl(element);
+        m_style->drawComplexControl(cc, options.complex(cc), painter, nullptr);
+    });
+}
+
+void tst_QGtkStyleBench::hitPath_data()
+{
+    QTest::addColumn<bool>("named");
+    QTest::addColumn<QString>("detail");
+
+    QTest::newRow("string") << true << QString();
+    QTest::newRow("string-detail") << true << QStringLiteral("checkbutton");
+    QTest::newRow("struct") << false << QString();
+    QTest::newRow("struct-detail") << false << QStringLiteral("checkbutton");
+}
+
+// The cache lookup of a paint function that hits, with the key it used
+// to build, a string of the part, state, shadow, size, widget, focus and
+// detail, and with the QGtkPainterKey and QGtkPainterExtra it builds now
+void tst_QGtkStyleBench::hitPath()
+{
+    QFETCH(bool, named);
+    QFETCH(QString, detail);
+
+    GtkWidget *widget = QGtkStylePrivate::gtkWidget(QGtkWidgetId::Button);
+    const gchar *part = "button";
+    const QSize size(100, 28);
+    QPixmap pixmap(size);
+    pixmap.fill(Qt::gray);
+
+    // Like the paint functions, the struct key interns its detail once
+    const quint32 detailId = detail.isEmpty() ? 0 : QGtkPainter::detailId(detail.toLatin1().constData());
+
+    auto makeName = [&] {
+        return QString(QLatin1String(part) % HexString<uint>(GTK_STATE_NORMAL) % HexString<uint>(GTK_SHADOW_OUT)
+                       % HexString<uint>(size.width()) % HexString<uint>(size.height())
+                       % HexString<quint64>(quint64(widget)) % QLatin1Char('f') % detail);
+    };
+    auto makeKey = [&] {
+        QGtkPainterKey key;
+        memset(&key, 0, sizeof(key));
+        key.element = 0; // QGtkPainter::Box
+        key.state = GTK_STATE_NORMAL;
+        key.shadow = GTK_SHADOW_OUT;
+        key.flags = 0x1;
+        key.width = size.width();
+        key.height = size.height();
+        key.part = part;
+        key.widget = widget;
+        key.dpr = 100;
+        key.extra = QGtkPainterExtra(QGtkPainterExtra::Focus, 0, 0, detailId);
+        return key;
+    };
+
+    QGtkPixmapCache::clear();
+    if (named)
+        QGtkPixmapCache::insert(makeName(), pixmap);
+    else
+        QGtkPixmapCache::insert(makeKey(), pixmap);
+
+    const int lookups = 200000;
+    QPixmap found;
+    bool hit = true;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < lookups; ++i)
+        hit &= named ? QGtkPixmapCache::find(makeName(), &found) : QGtkPixmapCache::find(makeKey(), &found);
+    const qint64 nsecs = timer.nsecsElapsed();
+    QVERIFY(hit);
+    QTest::setBenchmarkResult(qreal(nsecs) / lookups, QTest::WalltimeNanoseconds);
+}
+
+void tst_QGtkStyleBench::startup_data()
+{
+    QTest::addColumn<bool>("lazy");
+
+    QTest::newRow("lazy") << true;
+    QTest::newRow("eager") << false;
+}
+
+// The proto widgets live as long as the process, so every startup runs
+// startupChild() in a process of its own; the median of a few is kept
+void tst_QGtkStyleBench::startup()
+{
+    QFETCH(bool, lazy);
+
+    if (qEnvironmentVariableIsSet("QT6GTK2_BENCH_STARTUP"))
+        QSKIP("Run by startup() only");
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(QStringLiteral("QT6GTK2_BENCH_STARTUP"), QStringLiteral("1"));
+    environment.insert(QStringLiteral("QT6GTK2_LAZY_WIDGETS"), lazy ? QStringLiteral("1") : QStringLiteral("0"));
+    // Keep the application from loading a GTK+ style of its own
+    environment.insert(QStringLiteral("QT_STYLE_OVERRIDE"), QStringLiteral("Fusion"));
+    environment.remove(QStringLiteral("QT_QPA_PLATFORMTHEME"));
+
+    const int runs = 5;
+    QList<qint64> times;
+    for (int i = 0; i < runs; ++i) {
+        QProcess child;
+        child.setProcessEnvironment(environment);
+        child.start(QCoreApplication::applicationFilePath(), { QStringLiteral("startupChild") });
+        QVERIFY(child.waitForFinished(60000));
+        QCOMPARE(child.exitCode(), 0);
+        const QList<QByteArray> lines = child.readAllStandardOutput().split('\n');
+        for (const QByteArray &line : lines) {
+            if (line.startsWith("startup-ns "))
+                times.append(line.mid(11).trimmed().toLongLong());
+        }
+        QCOMPARE(times.size(), i + 1);
+    }
+    std::sort(times.begin(), times.end());
+    QTest::setBenchmarkResult(times.at(runs / 2), QTest::WalltimeNanoseconds);
+}
+
+void tst_QGtkStyleBench::startupChild()
+{
+    if (!qEnvironmentVariableIsSet("QT6GTK2_BENCH_STARTUP"))
+        QSKIP("Runs in the processes of startup()");
+
+    QImage image(100, 28, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QStyleOptionButton option;
+    option.rect = image.rect();
+    option.state = QStyle::State_Enabled | QStyle::State_Active | QStyle::State_Raised;
+    option.text = QStringLiteral("Text");
+    option.fontMetrics = QFontMetrics(QApplication::font());
+
+    QElapsedTimer timer;
+    timer.start();
+    QStyle *style = new QGtkStyle;
+    QPainter painter(&image);
+    style->drawControl(QStyle::CE_PushButton, &option, &painter, nullptr);
+    painter.end();
+    const qint64 nsecs = timer.nsecsElapsed();
+    delete style;
+
+    QVERIFY(QGtkStylePrivate::isThemeAvailable());
+    std::printf("startup-ns %lld\n", static_cast<long long>(nsecs));
+    std::fflush(stdout);
+}
+
+QTEST_MAIN(tst_QGtkStyleBench)
+
+#include "tst_qgtkstyle_bench.moc"